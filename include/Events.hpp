@@ -5,6 +5,16 @@
 #include <cstring>
 #include <algorithm>
 #include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <new>
+
+// 定义_EventProfile后，trigger()用DWT周期计数器统计每个监听器的耗时
+#ifdef _EventProfile
+#include <cstdio>
+#include "stm32f1xx_hal.h"
+#endif
 
 #ifndef MAX_EVENT_TYPES
 #define MAX_EVENT_TYPES 46
@@ -14,6 +24,26 @@
 #define MAX_LISTENERS_PER_EVENT 8
 #endif
 
+#ifndef EVENT_QUEUE_SIZE
+#define EVENT_QUEUE_SIZE 16          // 延迟事件队列容量（必须为2的幂）
+#endif
+
+#ifndef EVENT_QUEUE_SLOT_SIZE
+#define EVENT_QUEUE_SLOT_SIZE 20     // 单个排队事件的最大字节数
+#endif
+
+#ifndef EVENT_RECORDER_SIZE
+#define EVENT_RECORDER_SIZE 32       // 事件记录环形缓冲区条数
+#endif
+
+#ifndef EVENT_RECORD_PAYLOAD_SIZE
+#define EVENT_RECORD_PAYLOAD_SIZE 8  // 单条记录的最大负载字节数
+#endif
+
+#ifndef EVENT_RECORD_TYPES
+#define EVENT_RECORD_TYPES 32        // RECORD_ID取值上限（回放解码表大小）
+#endif
+
 enum class EventPriority {
     FIRST,
     NORMAL,
@@ -24,40 +54,353 @@ enum class EventPriority {
 namespace EmbeddedEvent {
 
 struct Event {};
+
+namespace detail {
+    // 全局事件类型计数器，每个事件类型首次使用时分配一个连续的ID
+    inline uint16_t& typeIdCounter() {
+        static uint16_t counter = 0;
+        return counter;
+    }
+}
+
+/**
+ * @brief 事件类型ID（0,1,2...连续分配）
+ * @details ID作为Dispatcher监听器表的下标，trigger时直接索引，无需查找
+ */
 template<typename T>
 struct TypeId {
+    static uint16_t get() {
+        static const uint16_t id = detail::typeIdCounter()++;
+        return id;
+    }
+};
+
+namespace detail {
+    class GenericClass;
+    // 单继承类成员函数指针的大小（GCC/ARM为两个字）
+    constexpr size_t MEMBER_PTR_SIZE = sizeof(void (GenericClass::*)());
+}
+
+/**
+ * @brief 轻量委托：内联保存对象指针与成员函数指针（或普通函数指针）
+ * @details 不使用std::function、不分配堆内存；调用为一次间接跳转+直接调用，
+ *          同一个类的多个对象可以分别注册为监听器。
+ */
+template<typename T>
+class Delegate {
 private:
-    static int id;
+    using Thunk = void(*)(const Delegate&, T&);
+    using FuncCallback = void(*)(T&);
+
+    Thunk m_thunk = nullptr;
+    void* m_instance = nullptr;
+    union {
+        FuncCallback m_func;
+        unsigned char m_method[detail::MEMBER_PTR_SIZE];
+    };
+
+    static void invokeFunction(const Delegate& d, T& event) {
+        d.m_func(event);
+    }
+
+    template<typename Class>
+    static void invokeMember(const Delegate& d, T& event) {
+        void (Class::*method)(T&);
+        std::memcpy(&method, d.m_method, sizeof(method));
+        (static_cast<Class*>(d.m_instance)->*method)(event);
+    }
+
 public:
-    static int get() { return id; }
+    Delegate() { std::memset(m_method, 0, sizeof(m_method)); }
+
+    // 绑定普通函数
+    static Delegate fromFunction(FuncCallback callback) {
+        Delegate d;
+        if (callback) {
+            d.m_func = callback;
+            d.m_thunk = &invokeFunction;
+        }
+        return d;
+    }
+
+    // 绑定对象的成员函数
+    template<typename Class>
+    static Delegate fromMember(Class* instance, void (Class::*callback)(T&)) {
+        static_assert(sizeof(callback) <= detail::MEMBER_PTR_SIZE, "不支持多继承/虚继承类的成员函数指针");
+        Delegate d;
+        if (instance && callback) {
+            std::memcpy(d.m_method, &callback, sizeof(callback));
+            d.m_instance = instance;
+            d.m_thunk = &invokeMember<Class>;
+        }
+        return d;
+    }
+
+    void operator()(T& event) const { m_thunk(*this, event); }
+
+    explicit operator bool() const { return m_thunk != nullptr; }
+
+    bool operator==(const Delegate& other) const {
+        return m_thunk == other.m_thunk && m_instance == other.m_instance &&
+               std::memcmp(m_method, other.m_method, sizeof(m_method)) == 0;
+    }
+    bool operator!=(const Delegate& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief 事件主题（Topic）
+ * @details 事件类型可声明 static constexpr uint16_t TOPIC_COUNT（≤64）和 uint16_t topic() const，
+ *          监听器注册时用TopicSet位集选择关心的主题，Dispatcher只调用主题匹配的监听器。
+ *          未声明主题的事件只有一个主题0。
+ */
+using TopicSet = uint64_t;
+constexpr TopicSet ALL_TOPICS = ~TopicSet(0);
+
+template<typename T, typename = void>
+struct TopicTraits {
+    static constexpr uint16_t count = 1;
+    static uint16_t topic(const T&) { return 0; }
 };
-template<typename T> int TypeId<T>::id = [](){ 
-    static int counter = 0; 
-    return counter++; 
-}();
-
-template<typename T, typename Class>
-struct MemberFunctionWrapper {
-    using Callback = void (Class::*)(T&);
-    Class* instance;
-    Callback callback;
-
-    static void wrapper(T& event) {
-        auto& wrapper = getInstance();
-        if (wrapper.instance && wrapper.callback) {
-            (wrapper.instance->*wrapper.callback)(event);
+
+template<typename T>
+struct TopicTraits<T, std::void_t<decltype(T::TOPIC_COUNT)>> {
+    static_assert(T::TOPIC_COUNT <= 64, "TOPIC_COUNT不能超过64");
+    static constexpr uint16_t count = T::TOPIC_COUNT;
+    static uint16_t topic(const T& event) { return event.topic(); }
+};
+
+#ifdef _EventProfile
+/**
+ * @brief 单个监听器的耗时统计（CPU周期）
+ * @details hist[k]统计耗时落在[2^k, 2^(k+1))周期内的调用次数，最后一档包含更长的调用
+ */
+struct ListenerStats {
+    static constexpr size_t HIST_BUCKETS = 16;
+    uint32_t calls = 0;
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0;
+    uint64_t total = 0;
+    uint16_t hist[HIST_BUCKETS] = {0};
+
+    void record(uint32_t cycles) {
+        ++calls;
+        total += cycles;
+        if (cycles < min) min = cycles;
+        if (cycles > max) max = cycles;
+        size_t bucket = 31 - __builtin_clz(cycles | 1u);
+        if (bucket >= HIST_BUCKETS) bucket = HIST_BUCKETS - 1;
+        if (hist[bucket] != UINT16_MAX) ++hist[bucket];
+    }
+
+    uint32_t mean() const {
+        return calls ? static_cast<uint32_t>(total / calls) : 0;
+    }
+
+    /**
+     * @brief 输出两行：name与调用次数/最小/最大/平均周期，以及log2直方图
+     */
+    template<typename Print>
+    void print(Print&& out, const char* name) const {
+        char line[128];
+        snprintf(line, sizeof(line), "%s calls=%lu min=%lu max=%lu mean=%lu", name,
+                 static_cast<unsigned long>(calls), static_cast<unsigned long>(min),
+                 static_cast<unsigned long>(max), static_cast<unsigned long>(mean()));
+        out(static_cast<const char*>(line));
+        int len = snprintf(line, sizeof(line), "  log2 hist:");
+        for (size_t b = 0; b < HIST_BUCKETS && len < static_cast<int>(sizeof(line)); ++b) {
+            len += snprintf(line + len, sizeof(line) - len, " %u", static_cast<unsigned>(hist[b]));
+        }
+        out(static_cast<const char*>(line));
+    }
+};
+
+namespace detail {
+    // 开启DWT周期计数器（Cortex-M3）
+    inline void enableCycleCounter() {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    inline uint32_t cycles() {
+        return DWT->CYCCNT;
+    }
+}
+#endif
+
+namespace detail {
+    // 排队事件自带 template<typename Router> void dispatch(Router&) const 时，出队由它展开
+    template<typename T, typename Router, typename = void>
+    struct HasQueueDispatch : std::false_type {};
+
+    template<typename T, typename Router>
+    struct HasQueueDispatch<T, Router,
+        std::void_t<decltype(std::declval<const T&>().dispatch(std::declval<Router&>()))>> : std::true_type {};
+}
+
+/**
+ * @brief 单生产者/单消费者无锁事件队列
+ * @details 中断中调用post()把事件按值拷贝进静态槽位（O(1)，不加锁、不分配内存），
+ *          主循环中调用dispatchOne()逐个取出并交给Router（Dispatcher/StaticRouter）同步触发。
+ *          事件类型提供dispatch(Router&)时改为调用它，一个槽位可展开成多个事件（要么全部送达，要么整条丢弃）。
+ *          队列满时丢弃并计数。同一队列只允许一个生产者上下文（如同一优先级的中断）写入。
+ */
+template<typename Router>
+class EventQueue {
+private:
+    static_assert((EVENT_QUEUE_SIZE & (EVENT_QUEUE_SIZE - 1)) == 0, "EVENT_QUEUE_SIZE必须为2的幂");
+    using DispatchFunc = void(*)(Router&, void*);
+
+    struct Slot {
+        DispatchFunc dispatch;
+        alignas(alignof(std::max_align_t)) unsigned char storage[EVENT_QUEUE_SLOT_SIZE];
+    };
+
+    std::array<Slot, EVENT_QUEUE_SIZE> m_slots;
+    std::atomic<uint16_t> m_head{0};   // 生产者写
+    std::atomic<uint16_t> m_tail{0};   // 消费者写
+    volatile uint16_t m_dropped = 0;   // 队列满丢弃计数
+
+    template<typename T>
+    static void dispatchSlot(Router& router, void* storage) {
+        T* event = std::launder(reinterpret_cast<T*>(storage));
+        if constexpr (detail::HasQueueDispatch<T, Router>::value) {
+            event->dispatch(router);
+        } else {
+            router.trigger(*event);
+        }
+    }
+
+public:
+    EventQueue() = default;
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    /**
+     * @brief 投递事件（可在中断中调用）
+     * @return 队列已满返回false
+     */
+    template<typename T>
+    bool post(const T& event) {
+        static_assert(std::is_base_of_v<Event, T>, "事件必须继承自EmbeddedEvent::Event");
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "排队事件必须可平凡拷贝");
+        static_assert(sizeof(T) <= EVENT_QUEUE_SLOT_SIZE, "事件超过EVENT_QUEUE_SLOT_SIZE");
+        uint16_t head = m_head.load(std::memory_order_relaxed);
+        uint16_t tail = m_tail.load(std::memory_order_acquire);
+        if (static_cast<uint16_t>(head - tail) >= EVENT_QUEUE_SIZE) {
+            m_dropped = m_dropped + 1;
+            return false;
         }
+        Slot& slot = m_slots[head & (EVENT_QUEUE_SIZE - 1)];
+        new (slot.storage) T(event);
+        slot.dispatch = &dispatchSlot<T>;
+        m_head.store(static_cast<uint16_t>(head + 1), std::memory_order_release);
+        return true;
     }
 
-    static MemberFunctionWrapper& getInstance() {
-        static MemberFunctionWrapper instance;
-        return instance;
+    /**
+     * @brief 取出一个事件并分发（仅主循环调用）
+     * @return 队列为空返回false
+     */
+    bool dispatchOne(Router& router) {
+        uint16_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) return false;
+        Slot& slot = m_slots[tail & (EVENT_QUEUE_SIZE - 1)];
+        slot.dispatch(router, slot.storage);
+        m_tail.store(static_cast<uint16_t>(tail + 1), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return m_tail.load(std::memory_order_relaxed) == m_head.load(std::memory_order_acquire);
+    }
+
+    uint16_t dropped() const { return m_dropped; }
+};
+
+/**
+ * @brief 可记录事件
+ * @details 事件类型声明 static constexpr uint8_t RECORD_ID（固件与主机两端保持一致，<EVENT_RECORD_TYPES）、
+ *          POD结构体Payload、Payload payload() const 以及构造函数 T(const Payload&)，
+ *          即可被EventRecorder记录并由EventReplayer回放。
+ */
+template<typename T, typename = void>
+struct IsRecordable : std::false_type {};
+
+template<typename T>
+struct IsRecordable<T, std::void_t<decltype(T::RECORD_ID), typename T::Payload>> : std::true_type {
+    static_assert(std::is_trivially_copyable_v<typename T::Payload>, "Payload必须可平凡拷贝");
+    static_assert(sizeof(typename T::Payload) <= EVENT_RECORD_PAYLOAD_SIZE, "Payload超过EVENT_RECORD_PAYLOAD_SIZE");
+    static_assert(T::RECORD_ID < EVENT_RECORD_TYPES, "RECORD_ID超过EVENT_RECORD_TYPES");
+};
+
+/**
+ * @brief 事件二进制记录器
+ * @details 挂到Dispatcher后，每次trigger()可记录事件都写入RAM环形缓冲区（满后覆盖最旧记录），
+ *          记录内容为RECORD_ID、tick（记录即分发时刻，ms）和Payload；事件自身的精确时刻（如GpioEvent的us时间戳）
+ *          应放进Payload。dump()按如下格式输出，可经串口发送到主机回放：
+ *          "EVR1" + 记录数(uint16 LE) + 每条[id(1)][len(1)][tick(uint32 LE)][payload(len)]
+ */
+class EventRecorder {
+public:
+    using TickSource = uint32_t(*)();
+
+private:
+    struct Record {
+        uint32_t tick;
+        uint8_t id;
+        uint8_t size;
+        uint8_t payload[EVENT_RECORD_PAYLOAD_SIZE];
+    };
+
+    std::array<Record, EVENT_RECORDER_SIZE> m_records;
+    TickSource m_tick;
+    uint16_t m_next = 0;    // 下一条写入位置
+    uint16_t m_count = 0;   // 有效记录数
+    bool m_enabled = true;
+
+public:
+    explicit EventRecorder(TickSource tick) : m_tick(tick) {}
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+
+    template<typename T>
+    void record(const T& event) {
+        static_assert(IsRecordable<T>::value, "事件未声明RECORD_ID/Payload");
+        if (!m_enabled) return;
+        Record& rec = m_records[m_next];
+        typename T::Payload payload = event.payload();
+        rec.tick = m_tick ? m_tick() : 0;
+        rec.id = T::RECORD_ID;
+        rec.size = sizeof(payload);
+        std::memcpy(rec.payload, &payload, sizeof(payload));
+        m_next = (m_next + 1) % EVENT_RECORDER_SIZE;
+        if (m_count < EVENT_RECORDER_SIZE) ++m_count;
     }
 
-    static void set(Class* inst, Callback cb) {
-        auto& wrapper = getInstance();
-        wrapper.instance = inst;
-        wrapper.callback = cb;
+    void setEnabled(bool enabled) { m_enabled = enabled; }
+    void clear() { m_next = 0; m_count = 0; }
+    size_t size() const { return m_count; }
+
+    /**
+     * @brief 从旧到新输出全部记录
+     * @param write 写出回调，参数为(const uint8_t* data, size_t len)，如转发给HAL_UART_Transmit
+     */
+    template<typename Write>
+    void dump(Write&& write) const {
+        uint8_t header[6] = {'E', 'V', 'R', '1',
+                             static_cast<uint8_t>(m_count & 0xFF), static_cast<uint8_t>(m_count >> 8)};
+        write(static_cast<const uint8_t*>(header), sizeof(header));
+        size_t start = (m_next + EVENT_RECORDER_SIZE - m_count) % EVENT_RECORDER_SIZE;
+        for (size_t n = 0; n < m_count; ++n) {
+            const Record& rec = m_records[(start + n) % EVENT_RECORDER_SIZE];
+            uint8_t head[6] = {rec.id, rec.size,
+                               static_cast<uint8_t>(rec.tick), static_cast<uint8_t>(rec.tick >> 8),
+                               static_cast<uint8_t>(rec.tick >> 16), static_cast<uint8_t>(rec.tick >> 24)};
+            write(static_cast<const uint8_t*>(head), sizeof(head));
+            write(static_cast<const uint8_t*>(rec.payload), static_cast<size_t>(rec.size));
+        }
     }
 };
 
@@ -65,37 +408,62 @@ class Dispatcher {
 private:
     template<typename T>
     struct Listener {
-        using FuncCallback = void(*)(T&);
-        FuncCallback callback;
+        Delegate<T> callback;
         EventPriority priority;
-        void* memberInstance = nullptr;
-        void* memberCallback = nullptr;
+        TopicSet topics;
+#ifdef _EventProfile
+        ListenerStats stats;
+#endif
     };
 
+    static_assert(MAX_LISTENERS_PER_EVENT <= 32, "MAX_LISTENERS_PER_EVENT不能超过32");
+    // 监听器下标位图，第i位表示listeners[i]
+    using ListenerMask = std::conditional_t<(MAX_LISTENERS_PER_EVENT <= 8), uint8_t,
+                         std::conditional_t<(MAX_LISTENERS_PER_EVENT <= 16), uint16_t, uint32_t>>;
+
     template<typename T>
     struct ListenerList {
         std::array<Listener<T>, MAX_LISTENERS_PER_EVENT> listeners;
         size_t count = 0;
+        std::array<ListenerMask, TopicTraits<T>::count> topicMap{};  // 主题→订阅该主题的监听器位图
     };
 
-    struct EventEntry {
-        int typeId;
-        void* listeners;
-    };
+    // 以TypeId为下标的监听器表（O(1)查找）
+    std::array<void*, MAX_EVENT_TYPES> m_eventMap;
+    // 与m_eventMap对应的清空函数（监听器表是静态对象，清除时需逐个复位）
+    using ClearFunc = void(*)(void* list);
+    std::array<ClearFunc, MAX_EVENT_TYPES> m_clearers{};
+    EventQueue<Dispatcher> m_queue;
+    EventRecorder* m_recorder = nullptr;
+
+#ifdef _EventProfile
+    // 按TypeId取出某事件类型全部监听器的统计数据，返回监听器数量
+    using StatsVisitor = size_t(*)(void* list, const ListenerStats** out);
+    std::array<StatsVisitor, MAX_EVENT_TYPES> m_statsVisitors{};
 
-    std::array<EventEntry, MAX_EVENT_TYPES> m_eventMap;
-    size_t m_eventCount = 0;
+    template<typename T>
+    static size_t visitStats(void* list, const ListenerStats** out) {
+        auto* listeners = static_cast<ListenerList<T>*>(list);
+        for (size_t i = 0; i < listeners->count; ++i) {
+            out[i] = &listeners->listeners[i].stats;
+        }
+        return listeners->count;
+    }
+#endif
+
+    template<typename T>
+    static void clearList(void* list) {
+        auto* listeners = static_cast<ListenerList<T>*>(list);
+        listeners->count = 0;
+        listeners->topicMap.fill(0);
+    }
 
     template<typename T>
     ListenerList<T>* findListeners() {
         static_assert(std::is_base_of_v<Event, T>, "事件必须继承自EmbeddedEvent::Event");
-        int typeId = TypeId<T>::get();
-        for (size_t i = 0; i < m_eventCount; ++i) {
-            if (m_eventMap[i].typeId == typeId) {
-                return static_cast<ListenerList<T>*>(m_eventMap[i].listeners);
-            }
-        }
-        return nullptr;
+        uint16_t typeId = TypeId<T>::get();
+        if (typeId >= MAX_EVENT_TYPES) return nullptr;
+        return static_cast<ListenerList<T>*>(m_eventMap[typeId]);
     }
 
     // 按优先级排序监听器
@@ -106,131 +474,433 @@ private:
             [](const Listener<T>& a, const Listener<T>& b) {
                 return a.priority < b.priority;
             });
+        rebuildTopics(list);
+    }
+
+    // 重建主题→监听器位图（注册/注销时执行，trigger时直接查表）
+    template<typename T>
+    void rebuildTopics(ListenerList<T>* list) {
+        for (size_t t = 0; t < list->topicMap.size(); ++t) {
+            ListenerMask mask = 0;
+            for (size_t i = 0; i < list->count; ++i) {
+                if ((list->listeners[i].topics >> t) & 1u) {
+                    mask |= static_cast<ListenerMask>(1u << i);
+                }
+            }
+            list->topicMap[t] = mask;
+        }
     }
 
 public:
     Dispatcher() {
-        std::memset(m_eventMap.data(), 0, sizeof(m_eventMap));
+        m_eventMap.fill(nullptr);
+#ifdef _EventProfile
+        detail::enableCycleCounter();
+#endif
     }
 
     Dispatcher(const Dispatcher&) = delete;
     Dispatcher& operator=(const Dispatcher&) = delete;
 
-    // 注册普通函数监听器
+    // 注册委托监听器
     template<typename T>
-    bool registerListener(void(*callback)(T&), EventPriority priority = EventPriority::NORMAL) {
+    bool registerListener(const Delegate<T>& callback, EventPriority priority = EventPriority::NORMAL,
+                          TopicSet topics = ALL_TOPICS) {
+        if (!callback) return false;
         auto listeners = findListeners<T>();
         if (!listeners) {
-            if (m_eventCount >= MAX_EVENT_TYPES) {
+            uint16_t typeId = TypeId<T>::get();
+            if (typeId >= MAX_EVENT_TYPES) {
                 return false; 
             }
             
             static ListenerList<T> newListeners;
-            m_eventMap[m_eventCount] = {TypeId<T>::get(), &newListeners};
+            m_eventMap[typeId] = &newListeners;
+            m_clearers[typeId] = &clearList<T>;
             listeners = &newListeners;
-            m_eventCount++;
+#ifdef _EventProfile
+            m_statsVisitors[typeId] = &visitStats<T>;
+#endif
         }
 
         // 添加监听器（不超过最大数量）
         if (listeners->count < MAX_LISTENERS_PER_EVENT) {
-            listeners->listeners[listeners->count++] = {callback, priority, nullptr, nullptr};
+            listeners->listeners[listeners->count++] = {callback, priority, topics};
             sortListeners(listeners);
             return true;
         }
         return false;
     }
 
-    // 注册成员函数监听器
+    // 注册普通函数监听器
+    template<typename T>
+    bool registerListener(void(*callback)(T&), EventPriority priority = EventPriority::NORMAL,
+                          TopicSet topics = ALL_TOPICS) {
+        return registerListener<T>(Delegate<T>::fromFunction(callback), priority, topics);
+    }
+
+    // 注册成员函数监听器（同一个类的多个对象可分别注册）
     template<typename T, typename Class>
-    bool registerListener(Class* instance, void (Class::*callback)(T&), EventPriority priority = EventPriority::NORMAL) {
-        using Wrapper = MemberFunctionWrapper<T, Class>;
-        Wrapper::set(instance, callback);
-        
-        // 注册包装器的静态函数
-        bool result = registerListener<T>(&Wrapper::wrapper, priority);
-        if (result) {
-            // 记录成员函数信息用于注销
-            auto listeners = findListeners<T>();
-            if (listeners && listeners->count > 0) {
-                auto& last = listeners->listeners[listeners->count - 1];
-                last.memberInstance = instance;
-                last.memberCallback = reinterpret_cast<void*>(callback);
-            }
-        }
-        return result;
+    bool registerListener(Class* instance, void (Class::*callback)(T&), EventPriority priority = EventPriority::NORMAL,
+                          TopicSet topics = ALL_TOPICS) {
+        return registerListener<T>(Delegate<T>::fromMember(instance, callback), priority, topics);
     }
 
-    // 注销普通函数监听器
+    // 注销委托监听器
     template<typename T>
-    bool unregisterListener(void(*callback)(T&)) {
+    bool unregisterListener(const Delegate<T>& callback) {
         auto listeners = findListeners<T>();
         if (!listeners) return false;
 
         for (size_t i = 0; i < listeners->count; ++i) {
-            if (listeners->listeners[i].callback == callback && 
-                !listeners->listeners[i].memberInstance) {
+            if (listeners->listeners[i].callback == callback) {
                 // 移动后续元素填补空缺
                 std::move(listeners->listeners.begin() + i + 1,
                           listeners->listeners.begin() + listeners->count,
                           listeners->listeners.begin() + i);
                 listeners->count--;
+                rebuildTopics(listeners);
                 return true;
             }
         }
         return false;
     }
 
+    // 注销普通函数监听器
+    template<typename T>
+    bool unregisterListener(void(*callback)(T&)) {
+        return unregisterListener<T>(Delegate<T>::fromFunction(callback));
+    }
+
     // 注销成员函数监听器
     template<typename T, typename Class>
     bool unregisterListener(Class* instance, void (Class::*callback)(T&)) {
-        using Wrapper = MemberFunctionWrapper<T, Class>;
-        auto listeners = findListeners<T>();
-        if (!listeners) return false;
-
-        for (size_t i = 0; i < listeners->count; ++i) {
-            if (listeners->listeners[i].callback == &Wrapper::wrapper &&
-                listeners->listeners[i].memberInstance == instance &&
-                listeners->listeners[i].memberCallback == reinterpret_cast<void*>(callback)) {
-                std::move(listeners->listeners.begin() + i + 1,
-                          listeners->listeners.begin() + listeners->count,
-                          listeners->listeners.begin() + i);
-                listeners->count--;
-                return true;
-            }
-        }
-        return false;
+        return unregisterListener<T>(Delegate<T>::fromMember(instance, callback));
     }
 
     // 触发事件
     template<typename T>
     void trigger(T& event) {
+        if constexpr (IsRecordable<T>::value) {
+            if (m_recorder) m_recorder->record(event);
+        }
         auto listeners = findListeners<T>();
         if (!listeners) return;
-        // 保存当前计数以防止迭代中修改
-        auto currentCount = listeners->count;
-        for (size_t i = 0; i < currentCount; ++i) {
-            if (listeners->listeners[i].callback) {
-                listeners->listeners[i].callback(event);
+        uint16_t topic = TopicTraits<T>::topic(event);
+        if (topic >= listeners->topicMap.size()) return;
+        // 先取出位图以防止迭代中修改，按位从低到高即优先级顺序
+        uint32_t mask = listeners->topicMap[topic];
+        while (mask) {
+            uint32_t i = __builtin_ctz(mask);
+            mask &= mask - 1;
+#ifdef _EventProfile
+            uint32_t start = detail::cycles();
+            listeners->listeners[i].callback(event);
+            listeners->listeners[i].stats.record(detail::cycles() - start);
+#else
+            listeners->listeners[i].callback(event);
+#endif
+        }
+    }
+
+#ifdef _EventProfile
+    /**
+     * @brief 输出所有监听器的耗时统计
+     * @param print 逐行输出回调，参数为const char*（如转发给Logger）
+     * @code manager.mDispatcher.dumpStats([](const char* line){ LogF.Log(LogLevel::DEBUG, line); });
+     */
+    template<typename Print>
+    void dumpStats(Print&& print) {
+        char name[24];
+        const ListenerStats* stats[MAX_LISTENERS_PER_EVENT];
+        for (size_t typeId = 0; typeId < MAX_EVENT_TYPES; ++typeId) {
+            if (!m_eventMap[typeId] || !m_statsVisitors[typeId]) continue;
+            size_t count = m_statsVisitors[typeId](m_eventMap[typeId], stats);
+            for (size_t i = 0; i < count; ++i) {
+                if (stats[i]->calls == 0) continue;
+                snprintf(name, sizeof(name), "type %u #%u", static_cast<unsigned>(typeId), static_cast<unsigned>(i));
+                stats[i]->print(print, name);
             }
         }
     }
+#endif
+
+    // 投递事件到延迟队列（中断安全，由dispatchQueued()在主循环中触发）
+    template<typename T>
+    bool post(const T& event) {
+        return m_queue.post(event);
+    }
+
+    // 分发一个排队事件，队列为空返回false
+    bool dispatchQueued() {
+        return m_queue.dispatchOne(*this);
+    }
+
+    EventQueue<Dispatcher>& queue() { return m_queue; }
 
     // 清除特定事件类型的所有监听器
     template<typename T>
     void clearListeners() {
         auto listeners = findListeners<T>();
         if (listeners) {
-            listeners->count = 0;
+            clearList<T>(listeners);
         }
     }
 
-    // 清除所有事件的监听器
+    // 清除所有事件的监听器（监听器表保留在m_eventMap中，之后注册直接复用）
     void clearAllListeners() {
-        for (size_t i = 0; i < m_eventCount; ++i) {
-            m_eventMap[i].typeId = 0;
-            m_eventMap[i].listeners = nullptr;
+        for (size_t typeId = 0; typeId < MAX_EVENT_TYPES; ++typeId) {
+            if (m_eventMap[typeId] && m_clearers[typeId]) {
+                m_clearers[typeId](m_eventMap[typeId]);
+            }
         }
-        m_eventCount = 0;
+    }
+
+    // 挂接事件记录器（nullptr为取消），之后trigger()的可记录事件都会写入记录器
+    void attachRecorder(EventRecorder* recorder) {
+        m_recorder = recorder;
+    }
+};
+
+namespace detail {
+    // 依赖模板参数的false，使static_assert只在实例化（被调用）时触发
+    template<typename...>
+    struct AlwaysFalse : std::false_type {};
+
+    template<typename F>
+    struct CallbackTraits;
+
+    template<typename T>
+    struct CallbackTraits<void(*)(T&)> {
+        using event_type = T;
+    };
+
+    template<typename Class, typename T>
+    struct CallbackTraits<void (Class::*)(T&)> {
+        using event_type = T;
+    };
+}
+
+/**
+ * @brief StaticRouter的普通函数处理器
+ * @tparam Callback 处理函数 void(*)(T&)
+ * @tparam Topics 主题过滤（同registerListener的topics参数）
+ */
+template<auto Callback, EventPriority Priority = EventPriority::NORMAL, TopicSet Topics = ALL_TOPICS>
+struct Handler {
+    using event_type = typename detail::CallbackTraits<decltype(Callback)>::event_type;
+    static constexpr EventPriority priority = Priority;
+    static constexpr TopicSet topics = Topics;
+    static inline void call(event_type& event) { Callback(event); }
+};
+
+/**
+ * @brief StaticRouter的成员函数处理器
+ * @tparam Instance 静态存储期的对象（如全局变量）
+ * @tparam Method 成员函数 void (Class::*)(T&)
+ */
+template<auto& Instance, auto Method, EventPriority Priority = EventPriority::NORMAL, TopicSet Topics = ALL_TOPICS>
+struct MemberHandler {
+    using event_type = typename detail::CallbackTraits<decltype(Method)>::event_type;
+    static constexpr EventPriority priority = Priority;
+    static constexpr TopicSet topics = Topics;
+    static inline void call(event_type& event) { (Instance.*Method)(event); }
+};
+
+/**
+ * @brief 编译期静态事件路由
+ * @details 处理器列表作为模板参数给出，trigger<T>()展开为按优先级排列的直接调用，
+ *          无函数指针、无运行时查表、无排序。trigger/post/dispatchQueued/attachRecorder/dumpStats
+ *          接口与Dispatcher一致；处理器固定于编译期，registerListener/unregisterListener/clearListeners/
+ *          clearAllListeners只保留同名声明，调用时以static_assert报错，提示把处理器加入模板参数。
+ * @code
+ *   using EventRouter = EmbeddedEvent::StaticRouter<
+ *       EmbeddedEvent::Handler<&OnButton, EventPriority::FIRST>,
+ *       EmbeddedEvent::MemberHandler<backlight, &Backlight::onGpio>>;
+ * @endcode
+ */
+template<typename... Handlers>
+class StaticRouter {
+private:
+    EventQueue<StaticRouter> m_queue;
+    EventRecorder* m_recorder = nullptr;
+
+#ifdef _EventProfile
+    // 每个处理器一份耗时统计
+    template<typename H>
+    static inline ListenerStats s_stats{};
+#endif
+
+    template<typename H, EventPriority P, typename T>
+    static inline void invoke(T& event) {
+        if constexpr (H::priority == P && std::is_same_v<typename H::event_type, T>) {
+            if constexpr (H::topics != ALL_TOPICS) {
+                uint16_t topic = TopicTraits<T>::topic(event);
+                if (topic >= TopicTraits<T>::count || !((H::topics >> topic) & 1u)) return;
+            }
+#ifdef _EventProfile
+            uint32_t start = detail::cycles();
+            H::call(event);
+            s_stats<H>.record(detail::cycles() - start);
+#else
+            H::call(event);
+#endif
+        }
+    }
+
+    template<EventPriority P, typename T>
+    static inline void invokeAll(T& event) {
+        (invoke<Handlers, P>(event), ...);
+    }
+
+public:
+    StaticRouter() {
+#ifdef _EventProfile
+        detail::enableCycleCounter();
+#endif
+    }
+    StaticRouter(const StaticRouter&) = delete;
+    StaticRouter& operator=(const StaticRouter&) = delete;
+
+    // 触发事件（按FIRST→NORMAL→LAST顺序，同优先级按模板参数顺序）
+    template<typename T>
+    void trigger(T& event) {
+        static_assert(std::is_base_of_v<Event, T>, "事件必须继承自EmbeddedEvent::Event");
+        if constexpr (IsRecordable<T>::value) {
+            if (m_recorder) m_recorder->record(event);
+        }
+        invokeAll<EventPriority::FIRST>(event);
+        invokeAll<EventPriority::NORMAL>(event);
+        invokeAll<EventPriority::LAST>(event);
+    }
+
+    // 投递事件到延迟队列（中断安全，由dispatchQueued()在主循环中触发）
+    template<typename T>
+    bool post(const T& event) {
+        return m_queue.post(event);
+    }
+
+    // 分发一个排队事件，队列为空返回false
+    bool dispatchQueued() {
+        return m_queue.dispatchOne(*this);
+    }
+
+    EventQueue<StaticRouter>& queue() { return m_queue; }
+
+    // 挂接事件记录器（nullptr为取消）
+    void attachRecorder(EventRecorder* recorder) {
+        m_recorder = recorder;
+    }
+
+    // 以下与Dispatcher同名的运行时注册接口不可用：由Dispatcher切换过来时在调用处给出明确的编译错误
+    template<typename T, typename... Args>
+    bool registerListener(Args&&...) {
+        static_assert(detail::AlwaysFalse<T, Args...>::value,
+                      "StaticRouter不支持运行时注册：把处理器写进StaticRouter<Handler<...>, ...>模板参数，或改用Dispatcher");
+        return false;
+    }
+
+    template<typename T, typename... Args>
+    bool unregisterListener(Args&&...) {
+        static_assert(detail::AlwaysFalse<T, Args...>::value,
+                      "StaticRouter不支持运行时注销：处理器在编译期固定，需要增删监听器请改用Dispatcher");
+        return false;
+    }
+
+    template<typename T>
+    void clearListeners() {
+        static_assert(detail::AlwaysFalse<T>::value,
+                      "StaticRouter不支持清空监听器：处理器在编译期固定，需要增删监听器请改用Dispatcher");
+    }
+
+    template<typename... None>
+    void clearAllListeners() {
+        static_assert(detail::AlwaysFalse<None...>::value,
+                      "StaticRouter不支持清空监听器：处理器在编译期固定，需要增删监听器请改用Dispatcher");
+    }
+
+#ifdef _EventProfile
+    /**
+     * @brief 输出所有处理器的耗时统计（按模板参数顺序编号）
+     * @param print 逐行输出回调，参数为const char*
+     */
+    template<typename Print>
+    void dumpStats(Print&& print) {
+        char name[24];
+        size_t index = 0;
+        auto dumpOne = [&](const ListenerStats& st) {
+            if (st.calls != 0) {
+                snprintf(name, sizeof(name), "handler #%u", static_cast<unsigned>(index));
+                st.print(print, name);
+            }
+            ++index;
+        };
+        (dumpOne(s_stats<Handlers>), ...);
+    }
+#endif
+};
+
+/**
+ * @brief 事件回放器（主机端/固件端通用）
+ * @details 解析EventRecorder::dump()输出的字节流，按记录顺序重建事件并交给Router触发，
+ *          用于在Linux上以全速复现现场时序问题、测试监听器代码。
+ *          需先对每种要回放的事件类型调用registerType<T>()。
+ */
+template<typename Router = Dispatcher>
+class EventReplayer {
+private:
+    using DecodeFunc = void(*)(Router&, const uint8_t*);
+    std::array<DecodeFunc, EVENT_RECORD_TYPES> m_decoders{};
+    std::array<uint8_t, EVENT_RECORD_TYPES> m_sizes{};
+
+    template<typename T>
+    static void decode(Router& router, const uint8_t* data) {
+        typename T::Payload payload;
+        std::memcpy(&payload, data, sizeof(payload));
+        T event(payload);
+        router.trigger(event);
+    }
+
+public:
+    template<typename T>
+    void registerType() {
+        static_assert(IsRecordable<T>::value, "事件未声明RECORD_ID/Payload");
+        m_decoders[T::RECORD_ID] = &decode<T>;
+        m_sizes[T::RECORD_ID] = sizeof(typename T::Payload);
+    }
+
+    /**
+     * @brief 回放一段记录
+     * @param onTick 每条记录触发前调用，参数为记录时的tick（可用于驱动主机端模拟时钟）
+     * @return 成功回放的记录数；数据头错误返回0，遇到截断的记录时停止
+     */
+    template<typename OnTick>
+    size_t replay(Router& router, const uint8_t* data, size_t len, OnTick&& onTick) {
+        if (data == nullptr || len < 6 || std::memcmp(data, "EVR1", 4) != 0) return 0;
+        size_t count = data[4] | (data[5] << 8);
+        size_t pos = 6;
+        size_t replayed = 0;
+        for (size_t n = 0; n < count; ++n) {
+            if (pos + 6 > len) break;
+            uint8_t id = data[pos];
+            uint8_t size = data[pos + 1];
+            uint32_t tick = static_cast<uint32_t>(data[pos + 2]) | (static_cast<uint32_t>(data[pos + 3]) << 8) |
+                            (static_cast<uint32_t>(data[pos + 4]) << 16) | (static_cast<uint32_t>(data[pos + 5]) << 24);
+            pos += 6;
+            if (pos + size > len) break;
+            // 未注册或负载长度不符的记录直接跳过
+            if (id < EVENT_RECORD_TYPES && m_decoders[id] && m_sizes[id] == size) {
+                onTick(tick);
+                m_decoders[id](router, data + pos);
+                ++replayed;
+            }
+            pos += size;
+        }
+        return replayed;
+    }
+
+    size_t replay(Router& router, const uint8_t* data, size_t len) {
+        return replay(router, data, len, [](uint32_t) {});
     }
 };
 
@@ -239,35 +909,26 @@ template<typename T>
 class ScopedListener {
 private:
     Dispatcher& m_dispatcher;
-    void(*m_funcCallback)(T&) = nullptr;
-    void* m_memberInstance = nullptr;
-    void* m_memberCallback = nullptr;
-    bool m_isMember = false;
+    Delegate<T> m_callback;
 
 public:
     // 普通函数构造函数
-    ScopedListener(Dispatcher& dispatcher, void(*callback)(T&), EventPriority priority = EventPriority::NORMAL)
-        : m_dispatcher(dispatcher), m_funcCallback(callback) {
-        m_dispatcher.registerListener<T>(callback, priority);
+    ScopedListener(Dispatcher& dispatcher, void(*callback)(T&), EventPriority priority = EventPriority::NORMAL,
+                   TopicSet topics = ALL_TOPICS)
+        : m_dispatcher(dispatcher), m_callback(Delegate<T>::fromFunction(callback)) {
+        m_dispatcher.registerListener<T>(m_callback, priority, topics);
     }
 
     // 成员函数构造函数
     template<typename Class>
-    ScopedListener(Dispatcher& dispatcher, Class* instance, void (Class::*callback)(T&), EventPriority priority = EventPriority::NORMAL)
-        : m_dispatcher(dispatcher), m_memberInstance(instance), m_memberCallback(reinterpret_cast<void*>(callback)), m_isMember(true) {
-        m_dispatcher.registerListener<T, Class>(instance, callback, priority);
+    ScopedListener(Dispatcher& dispatcher, Class* instance, void (Class::*callback)(T&), EventPriority priority = EventPriority::NORMAL,
+                   TopicSet topics = ALL_TOPICS)
+        : m_dispatcher(dispatcher), m_callback(Delegate<T>::fromMember(instance, callback)) {
+        m_dispatcher.registerListener<T>(m_callback, priority, topics);
     }
 
     ~ScopedListener() {
-        if (m_isMember) {
-            using Class = typename std::remove_pointer<decltype(m_memberInstance)>::type;
-            m_dispatcher.unregisterListener<T, Class>(
-                static_cast<Class*>(m_memberInstance),
-                reinterpret_cast<void(Class::*)(T&)>(m_memberCallback)
-            );
-        } else if (m_funcCallback) {
-            m_dispatcher.unregisterListener<T>(m_funcCallback);
-        }
+        m_dispatcher.unregisterListener<T>(m_callback);
     }
 
     ScopedListener(const ScopedListener&) = delete;
@@ -0,0 +1,173 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include "stm32f1xx_hal.h"
+
+/**
+ * @brief 外设时钟编号（与CLOCK_TABLE一一对应）
+ */
+enum class ClockId : uint8_t {
+    GpioA,
+    GpioB,
+    GpioC,
+    GpioD,
+    Afio,
+    Tim1,
+    Tim2,
+    Tim3,
+    I2c1,
+    Usart1,
+    Usart2,
+    Spi1,
+    Adc1,
+    Adc2,
+    Dma1,
+    Count
+};
+
+enum class ClockBus : uint8_t { AHB, APB1, APB2 };
+
+struct ClockEntry {
+    uintptr_t base;     // 外设基地址
+    ClockBus bus;       // 所在总线（决定写哪个ENR寄存器）
+    uint32_t enable;    // ENR中的使能位
+};
+
+static constexpr size_t CLOCK_COUNT = static_cast<size_t>(ClockId::Count);
+static constexpr uintptr_t CLOCK_PERIPH_SPAN = 0x400;  // 每个外设占用的地址空间
+
+// 外设时钟表，顺序与ClockId一致
+static constexpr std::array<ClockEntry, CLOCK_COUNT> CLOCK_TABLE = {{
+    {GPIOA_BASE,  ClockBus::APB2, RCC_APB2ENR_IOPAEN},
+    {GPIOB_BASE,  ClockBus::APB2, RCC_APB2ENR_IOPBEN},
+    {GPIOC_BASE,  ClockBus::APB2, RCC_APB2ENR_IOPCEN},
+    {GPIOD_BASE,  ClockBus::APB2, RCC_APB2ENR_IOPDEN},
+    {AFIO_BASE,   ClockBus::APB2, RCC_APB2ENR_AFIOEN},
+    {TIM1_BASE,   ClockBus::APB2, RCC_APB2ENR_TIM1EN},
+    {TIM2_BASE,   ClockBus::APB1, RCC_APB1ENR_TIM2EN},
+    {TIM3_BASE,   ClockBus::APB1, RCC_APB1ENR_TIM3EN},
+    {I2C1_BASE,   ClockBus::APB1, RCC_APB1ENR_I2C1EN},
+    {USART1_BASE, ClockBus::APB2, RCC_APB2ENR_USART1EN},
+    {USART2_BASE, ClockBus::APB1, RCC_APB1ENR_USART2EN},
+    {SPI1_BASE,   ClockBus::APB2, RCC_APB2ENR_SPI1EN},
+    {ADC1_BASE,   ClockBus::APB2, RCC_APB2ENR_ADC1EN},
+    {ADC2_BASE,   ClockBus::APB2, RCC_APB2ENR_ADC2EN},
+    {DMA1_BASE,   ClockBus::AHB,  RCC_AHBENR_DMA1EN},
+}};
+
+/**
+ * @brief 外设时钟管理：按引用计数开关时钟，最后一个使用者释放时关闭时钟以降低功耗
+ * @details 首次Acquire时若时钟已被外部代码（如MspInit、USART1_UART_Init）打开，
+ *          则视为外部持有，计数归零时不关闭，避免切断别人的外设。
+ *          Acquire/Release在关中断的临界区内修改计数与ENR寄存器，主循环与中断中均可调用
+ */
+class ClockManager {
+public:
+    ClockManager() = delete;
+
+    /**
+     * @brief 引用一个外设时钟，计数从0变1时打开时钟
+     */
+    static void Acquire(ClockId id) {
+        size_t i = static_cast<size_t>(id);
+        if (i >= CLOCK_COUNT) return;
+        IrqLock lock;
+        if (s_refs[i]++ == 0) {
+            const ClockEntry& entry = CLOCK_TABLE[i];
+            volatile uint32_t* reg = enableRegister(entry.bus);
+            if (*reg & entry.enable) {
+                s_external |= 1u << i;
+            } else {
+                *reg |= entry.enable;
+                (void)*reg;  // 回读，确保时钟生效后再访问外设
+            }
+        }
+    }
+
+    /**
+     * @brief 释放一个外设时钟，计数归零时关闭时钟（外部持有的时钟除外）
+     */
+    static void Release(ClockId id) {
+        size_t i = static_cast<size_t>(id);
+        if (i >= CLOCK_COUNT) return;
+        IrqLock lock;
+        if (s_refs[i] == 0) return;
+        if (--s_refs[i] == 0) {
+            if (!(s_external & (1u << i))) {
+                const ClockEntry& entry = CLOCK_TABLE[i];
+                *enableRegister(entry.bus) &= ~entry.enable;
+            }
+            s_external &= ~(1u << i);
+        }
+    }
+
+    /**
+     * @brief 按外设实例地址引用时钟（如htim.Instance、GPIOA）
+     * @return 找到对应时钟返回true；nullptr或表外外设返回false
+     */
+    static bool Acquire(const void* instance) {
+        ClockId id = Find(instance);
+        if (id == ClockId::Count) return false;
+        Acquire(id);
+        return true;
+    }
+
+    static bool Release(const void* instance) {
+        ClockId id = Find(instance);
+        if (id == ClockId::Count) return false;
+        Release(id);
+        return true;
+    }
+
+    /**
+     * @brief 外设实例地址 → 时钟编号，不在表中返回ClockId::Count
+     */
+    static ClockId Find(const void* instance) {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(instance);
+        if (addr == 0) return ClockId::Count;
+        for (size_t i = 0; i < CLOCK_COUNT; ++i) {
+            if (addr - CLOCK_TABLE[i].base < CLOCK_PERIPH_SPAN) {
+                return static_cast<ClockId>(i);
+            }
+        }
+        return ClockId::Count;
+    }
+
+    // 当前引用计数
+    static uint16_t RefCount(ClockId id) {
+        size_t i = static_cast<size_t>(id);
+        return i < CLOCK_COUNT ? s_refs[i] : 0;
+    }
+
+    // 时钟当前是否打开（直接读ENR寄存器）
+    static bool IsEnabled(ClockId id) {
+        size_t i = static_cast<size_t>(id);
+        if (i >= CLOCK_COUNT) return false;
+        return (*enableRegister(CLOCK_TABLE[i].bus) & CLOCK_TABLE[i].enable) != 0;
+    }
+
+private:
+    static_assert(CLOCK_COUNT <= 32, "外部持有位图为32位");
+
+    static inline std::array<uint16_t, CLOCK_COUNT> s_refs{};  // 每个时钟的引用计数
+    static inline uint32_t s_external = 0;                     // 首次引用前已被外部打开的时钟
+
+    // 临界区：保存PRIMASK后关中断，析构时恢复（嵌套调用或调用前已关中断时不会误开中断）
+    class IrqLock {
+    public:
+        IrqLock() : m_primask(__get_PRIMASK()) { __disable_irq(); }
+        ~IrqLock() { __set_PRIMASK(m_primask); }
+        IrqLock(const IrqLock&) = delete;
+        IrqLock& operator=(const IrqLock&) = delete;
+    private:
+        uint32_t m_primask;
+    };
+
+    static volatile uint32_t* enableRegister(ClockBus bus) {
+        switch (bus) {
+            case ClockBus::AHB:  return &RCC->AHBENR;
+            case ClockBus::APB1: return &RCC->APB1ENR;
+            default:             return &RCC->APB2ENR;
+        }
+    }
+};
@@ -0,0 +1,65 @@
+#include "GPIO.hpp"
+
+/**
+ * @brief 当前时间（us）：HAL tick（ms）+ SysTick当前计数换算
+ * @details EXTI优先级高于SysTick，中断期间发生的溢出只会挂起SysTick，tick不会增加：
+ *          此时PENDSTSET置位，需补上一个周期（1ms）。读VAL前后挂起状态不一致时说明
+ *          恰在读取中溢出，重读一次使VAL与挂起状态对应
+ */
+static inline uint32_t extiTimestamp() {
+    uint32_t ms, val, pending;
+    do {
+        ms = HAL_GetTick();
+        pending = SCB->ICSR & SCB_ICSR_PENDSTSET_Msk;
+        val = SysTick->VAL;
+    } while (ms != HAL_GetTick() || pending != (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk));
+    if (pending) ms += 1;
+    uint32_t load = SysTick->LOAD + 1;
+    return tick_to_us(ms) + (load - val) * 1000 / load;
+}
+
+void GPIO::HandleExti(uint16_t lines) {
+    uint32_t pending = EXTI->PR & lines;
+    EXTI->PR = pending;  // 写1清除挂起位
+    if (pending == 0 || s_extiCallback == nullptr) return;
+    uint32_t timestamp = extiTimestamp();
+    while (pending) {
+        uint8_t line = __builtin_ctz(pending);
+        pending &= pending - 1;
+        GPIO_TypeDef* port = s_extiPort[line];
+        if (port == nullptr) continue;
+        uint16_t pin = static_cast<uint16_t>(1u << line);
+        GPIO_PinState state = (port->IDR & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+        s_extiCallback(port, pin, state, timestamp);
+    }
+}
+
+extern "C" void EXTI0_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_0);
+}
+
+extern "C" void EXTI1_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_1);
+}
+
+extern "C" void EXTI2_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_2);
+}
+
+extern "C" void EXTI3_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_3);
+}
+
+extern "C" void EXTI4_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_4);
+}
+
+// EXTI5~9共用一个中断向量
+extern "C" void EXTI9_5_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_5 | GPIO_PIN_6 | GPIO_PIN_7 | GPIO_PIN_8 | GPIO_PIN_9);
+}
+
+// EXTI10~15共用一个中断向量
+extern "C" void EXTI15_10_IRQHandler(void) {
+    GPIO::HandleExti(GPIO_PIN_10 | GPIO_PIN_11 | GPIO_PIN_12 | GPIO_PIN_13 | GPIO_PIN_14 | GPIO_PIN_15);
+}
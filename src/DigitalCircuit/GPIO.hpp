@@ -1,8 +1,7 @@
 #pragma once
-#include <memory>
-#include <unordered_map>
+#include <array>
+#include <tuple>
 #include <cstdint>
-#include <functional>  
 #include "stm32f1xx_hal.h"
 
 #include "DataChannel.hpp"
@@ -10,6 +9,22 @@
 #include "ADC.hpp"
 #include "UARTChannel.hpp"
 #include "DMAChannel.hpp"
+#include "Clock.hpp"
+#include "GpioPort.hpp"
+
+// 所有EXTI线必须使用同一抢占优先级：事件队列是单生产者队列，
+// 不同优先级的EXTI可以互相抢占，同时post()会写坏队列
+#ifndef GPIO_EXTI_PRIORITY
+#define GPIO_EXTI_PRIORITY 2  // EXTI中断抢占优先级
+#endif
+
+#ifndef LCD_DMA_IRQ_PRIORITY
+#define LCD_DMA_IRQ_PRIORITY 3  // LCD SPI1 DMA传输完成中断抢占优先级（低于EXTI）
+#endif
+
+#ifndef MAX_GPIO_PINS
+#define MAX_GPIO_PINS 16    // 引脚池大小（静态分配）
+#endif
 
 using GpioKey = uint64_t;
 
@@ -23,66 +38,153 @@ inline void decompose_key(GpioKey key, GPIO_TypeDef*& port, uint16_t& pin) {
     pin = static_cast<uint16_t>(key & 0xFFFF);  // 低32位的低16位是引脚号
 }
 
+static_assert(static_cast<uint8_t>(ClockId::GpioA) == 0 &&
+              static_cast<uint8_t>(ClockId::GpioD) == GPIO_PORT_COUNT - 1,
+              "端口下标需与ClockId::GpioA~GpioD一致");
+
+/**
+ * @brief 引脚位图的范围视图：从低到高依次产出单个引脚位
+ * @code for (uint16_t pin : PinBits(changed)) { ... }
+ */
+class PinBits {
+public:
+    class iterator {
+    public:
+        explicit iterator(uint16_t rest) : m_rest(rest) {}
+        uint16_t operator*() const { return m_rest & -m_rest; }  // 取最低位引脚
+        iterator& operator++() { m_rest &= m_rest - 1; return *this; }
+        bool operator!=(const iterator& other) const { return m_rest != other.m_rest; }
+    private:
+        uint16_t m_rest;
+    };
+
+    explicit PinBits(uint16_t mask) : m_mask(mask) {}
+    iterator begin() const { return iterator(m_mask); }
+    iterator end() const { return iterator(0); }
+
+private:
+    uint16_t m_mask;
+};
+
+/**
+ * @brief 引脚绑定的外设：类型标签 + 指向共享通道对象的指针（不拷贝通道）
+ * @details 通道对象由使用者持有（全局或Manager成员），同一外设的多个引脚指向同一个对象
+ * @code static UARTChannel uart1(huart); gpio.Add(GPIOA, {GPIO_PIN_9, ...}, Hardware(uart1));
+ */
 class Hardware {
 public:
-    PWMChannel pwm_channel;
-    SPIChannel spi_channel;
-    I2CChannel i2c_channel;
-    DMAChannel dma_channel;
-    ADCChannel adc_channel;
-    UARTChannel uart_channel;
-    
+    enum class Type : uint8_t { None, PWM, SPI, I2C, DMA, ADC, UART };
+
     Hardware() = default;
+    Hardware(UARTChannel& uart) : m_type(Type::UART), m_channel(&uart) {}
+    Hardware(PWMChannel& pwm) : m_type(Type::PWM), m_channel(&pwm) {}
+    Hardware(SPIChannel& spi) : m_type(Type::SPI), m_channel(&spi) {}
+    Hardware(I2CChannel& i2c) : m_type(Type::I2C), m_channel(&i2c) {}
+    Hardware(DMAChannel& dma) : m_type(Type::DMA), m_channel(&dma) {}
+    Hardware(ADCChannel& adc) : m_type(Type::ADC), m_channel(&adc) {}
 
-    Hardware(UARTChannel uart){
-        uart_channel = uart;
-    }
-     Hardware(PWMChannel pwm){
-        pwm_channel = pwm;
-    }
-    Hardware(SPIChannel spi) {
-        spi_channel = spi;
-    }
-    Hardware(I2CChannel i2c){
-        i2c_channel = i2c;
-    }
-    Hardware(DMAChannel dma){
-        dma_channel = dma;
+    Type type() const { return m_type; }
+
+    // 类型不符时返回nullptr
+    PWMChannel* pwm() const { return get<PWMChannel>(Type::PWM); }
+    SPIChannel* spi() const { return get<SPIChannel>(Type::SPI); }
+    I2CChannel* i2c() const { return get<I2CChannel>(Type::I2C); }
+    DMAChannel* dma() const { return get<DMAChannel>(Type::DMA); }
+    ADCChannel* adc() const { return get<ADCChannel>(Type::ADC); }
+    UARTChannel* uart() const { return get<UARTChannel>(Type::UART); }
+
+    /**
+     * @brief 绑定外设的HAL实例地址（用于查找时钟），未绑定返回nullptr
+     */
+    const void* instance() const {
+        switch (m_type) {
+            case Type::PWM:  return pwm()->htim.Instance;
+            case Type::SPI:  return spi()->hspi1.Instance;
+            case Type::I2C:  return i2c()->hi2c.Instance;
+            case Type::DMA:  return dma()->hdma.Instance;
+            case Type::ADC:  return adc()->hadc.Instance;
+            case Type::UART: return uart()->huart1.Instance;
+            default:         return nullptr;
+        }
     }
-    Hardware(ADCChannel adc){
-        adc_channel = adc;
+
+private:
+    Type m_type = Type::None;
+    void* m_channel = nullptr;
+
+    template<typename T>
+    T* get(Type type) const {
+        return m_type == type ? static_cast<T*>(m_channel) : nullptr;
     }
 };
 
 class GpioData {
 public:
-    bool Data_initialized;
-    bool Gpio_initialized;               // 初始化状态标记
+    bool Data_initialized = false;
+    bool Gpio_initialized = false;       // 初始化状态标记
     GPIO_TypeDef* port = nullptr;           // GPIO端口指针
     GPIO_InitTypeDef init_config;           // GPIO初始化配置
-    Hardware hardware_info;                 // 硬件相关信息
+    Hardware hardware_info;                 // 绑定的外设（标签+指针）
+    uint32_t change_tick = 0;               // 采样电平最近一次变化的tick
+    uint16_t debounce_ms = 0;               // 消抖窗口（ms），0表示不消抖
 };
 
 class GPIO {
 private:
-    static constexpr size_t MAX_GPIO_PINS = 64;  // 最大支持64个引脚
-    std::array<std::unique_ptr<GpioData>, MAX_GPIO_PINS> m_gpio_array;
+    static constexpr uint8_t NO_SLOT = 0xFF;
+    std::array<GpioData, MAX_GPIO_PINS> m_gpio_array;  // 引脚池（按添加顺序）
     size_t m_count = 0;  // 当前已添加的引脚数量
+    // 端口下标×引脚号 → 引脚池下标，O(1)查找
+    std::array<std::array<uint8_t, 16>, GPIO_PORT_COUNT> m_slot;
+    std::array<uint16_t, GPIO_PORT_COUNT> m_used{};     // 每个端口已添加引脚的位图
+    std::array<uint16_t, GPIO_PORT_COUNT> m_polled{};       // 已初始化且需轮询的引脚位图（不含中断模式引脚）
+    std::array<uint16_t, GPIO_PORT_COUNT> m_snapshot{};     // 上一次采样的IDR（仅轮询引脚）
+    std::array<uint16_t, GPIO_PORT_COUNT> m_stable{};       // 消抖后的稳定电平
+    std::array<uint8_t, 16> m_extiOwner;                    // EXTI线 → 已添加的中断引脚所在端口下标
+
+    GpioData* slotData(uint8_t index, uint16_t pin) {
+        if (index >= GPIO_PORT_COUNT || pin == 0) return nullptr;
+        uint8_t slot = m_slot[index][__builtin_ctz(pin)];
+        return slot == NO_SLOT ? nullptr : &m_gpio_array[slot];
+    }
 public:
 
-    std::array<std::pair<bool, size_t>, 16> clock{};
     /**
-     * [0] GPIOA
-     * [1] GPIOB
-     * [2] GPIOC
-     * [3] TIM1
-     * [4] TIM2
-     * [5] TIM3
-     * [6] I2C1
+     * @brief EXTI边沿回调（在中断中执行，应尽快返回，如只投递事件）
+     * @param port 引脚所在端口
+     * @param pin 引脚位
+     * @param state 边沿后的电平
+     * @param timestamp 边沿时间（us，基于HAL tick + SysTick计数）
      */
+    using ExtiCallback = void(*)(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state, uint32_t timestamp);
+
+    /**
+     * @brief 设置EXTI边沿回调
+     * @note 与ForEach等模板不同，这里保持函数指针：回调在中断里运行时才确定，需存入静态变量，
+     *       不能是带捕获的lambda（模板化也无法内联）
+     */
+    static void SetExtiCallback(ExtiCallback callback) {
+        s_extiCallback = callback;
+    }
+
+    /**
+     * @brief 处理一组EXTI线的挂起中断（由EXTIx_IRQHandler调用）
+     * @param lines 该中断向量对应的EXTI线位图
+     */
+    static void HandleExti(uint16_t lines);
+
+    static bool IsExtiMode(uint32_t mode) {
+        return mode == GPIO_MODE_IT_RISING || mode == GPIO_MODE_IT_FALLING ||
+               mode == GPIO_MODE_IT_RISING_FALLING;
+    }
 
 
-    GPIO() = default;
+    GPIO() {
+        for (auto& port : m_slot) {
+            port.fill(NO_SLOT);
+        }
+        m_extiOwner.fill(NO_SLOT);
+    }
     ~GPIO() = default;
 
     GPIO(const GPIO&) = delete;
@@ -91,38 +193,137 @@ public:
     size_t GetGpioSize(){
         return m_count;
     }
-    std::array<std::unique_ptr<GpioData>, MAX_GPIO_PINS>& Get_gpio_array(){
-        return m_gpio_array;
+    /**
+     * @brief 端口已添加引脚的位图（bit n 对应 GPIO_PIN_n）
+     */
+    uint16_t GetUsedMask(GPIO_TypeDef* port) {
+        uint8_t index = port_index(port);
+        return index < GPIO_PORT_COUNT ? m_used[index] : 0;
     }
     /**
      * @brief 添加GPIO引脚配置
+     * @details init.Pin可包含多个引脚，它们共用同一份配置
+     * @return 池已满、引脚已添加过，或中断模式引脚的EXTI线已被其他端口占用（如PA3与PB3同为EXTI3）时返回false
      */
-      void Add(GPIO_TypeDef* port, const GPIO_InitTypeDef& init, 
+      bool Add(GPIO_TypeDef* port, const GPIO_InitTypeDef& init, 
              const Hardware& hardware = Hardware()) {
-        if (port == nullptr || m_count >= MAX_GPIO_PINS) return;  // 检查容量
-        
-        auto data = std::make_unique<GpioData>();
-        data->port = port;
-        data->init_config = init;
-        data->hardware_info = hardware;
-        data->Gpio_initialized = false;
-        data->Data_initialized = false;
-        m_gpio_array[m_count++] = std::move(data);  // 存入数组
+        uint8_t index = port_index(port);
+        uint16_t pins = static_cast<uint16_t>(init.Pin);
+        if (index >= GPIO_PORT_COUNT || pins == 0 || m_count >= MAX_GPIO_PINS) return false;  // 检查容量
+        if (m_used[index] & pins) return false;  // 引脚重复
+        bool exti = IsExtiMode(init.Mode);
+        if (exti && !ExtiLinesFree(index, pins)) return false;
+
+        GpioData& data = m_gpio_array[m_count];
+        data.port = port;
+        data.init_config = init;
+        data.hardware_info = hardware;
+        data.Gpio_initialized = false;
+        data.Data_initialized = false;
+        for (uint16_t pin : PinBits(pins)) {
+            m_slot[index][__builtin_ctz(pin)] = static_cast<uint8_t>(m_count);
+        }
+        if (exti) {
+            for (uint16_t pin : PinBits(pins)) {
+                m_extiOwner[__builtin_ctz(pin)] = index;
+            }
+        }
+        m_used[index] |= pins;
+        ++m_count;
+        return true;
+    }
+
+    /**
+     * @brief 登记已直接写寄存器配置好的引脚（如PinMap），不占用引脚池
+     * @param index 端口下标
+     * @param pins 引脚位图
+     * @param inputs 其中需要轮询的输入引脚（无消抖，事件Data为nullptr）
+     * @return 有引脚已被占用时返回false
+     */
+    bool Claim(uint8_t index, uint16_t pins, uint16_t inputs) {
+        if (index >= GPIO_PORT_COUNT || (m_used[index] & pins)) return false;
+        m_used[index] |= pins;
+        inputs &= pins;
+        if (inputs == 0) return true;
+        uint16_t level = static_cast<uint16_t>(port_from_index(index)->IDR) & inputs;
+        m_polled[index] |= inputs;
+        m_snapshot[index] = (m_snapshot[index] & ~inputs) | level;
+        m_stable[index] = (m_stable[index] & ~inputs) | level;
+        return true;
+    }
+
+    /**
+     * @brief 撤销Claim()登记：引脚不再被占用和轮询（寄存器与时钟由调用者复位/释放）
+     * @return 有引脚未被登记或属于引脚池时返回false
+     */
+    bool Unclaim(uint8_t index, uint16_t pins) {
+        if (index >= GPIO_PORT_COUNT || (m_used[index] & pins) != pins) return false;
+        for (uint16_t pin : PinBits(pins)) {
+            if (m_slot[index][__builtin_ctz(pin)] != NO_SLOT) return false;
+        }
+        m_used[index] &= ~pins;
+        m_polled[index] &= ~pins;
+        m_snapshot[index] &= ~pins;
+        m_stable[index] &= ~pins;
+        return true;
     }
 
     /**
-     * @brief 获取指定引脚的配置数据
+     * @brief 获取指定引脚的配置数据（O(1)）
      * @return 找到返回GpioData指针，否则返回nullptr
      */
      GpioData* GetData(GPIO_TypeDef* port, uint16_t pin) {
         if (port == nullptr || pin == 0) return nullptr;
-        for (size_t i = 0; i < m_count; ++i) {
-            auto& data = m_gpio_array[i];
-            if (data && data->port == port && data->init_config.Pin == pin) {
-                return data.get();
-            }
-        }
-        return nullptr;
+        return slotData(port_index(port), pin);
+    }
+
+    /**
+     * @brief 按端口下标获取引脚数据（O(1)）
+     */
+    GpioData* GetDataAt(uint8_t index, uint16_t pin) {
+        return slotData(index, pin);
+    }
+
+    /**
+     * @brief 整端口采样：读取一次IDR并与上次快照异或
+     * @param index 端口下标（port_index()）
+     * @return 自上次采样以来电平发生变化的引脚位图（仅轮询引脚）
+     */
+    uint16_t SampleChanges(uint8_t index) {
+        if (index >= GPIO_PORT_COUNT || m_polled[index] == 0) return 0;
+        uint16_t level = static_cast<uint16_t>(port_from_index(index)->IDR) & m_polled[index];
+        uint16_t changed = level ^ m_snapshot[index];
+        m_snapshot[index] = level;
+        return changed;
+    }
+
+    // 最近一次采样的电平位图
+    uint16_t GetSnapshot(uint8_t index) {
+        return index < GPIO_PORT_COUNT ? m_snapshot[index] : 0;
+    }
+
+    // 采样电平与稳定电平不一致（等待消抖确认）的引脚位图
+    uint16_t GetPending(uint8_t index) {
+        return index < GPIO_PORT_COUNT ? (m_snapshot[index] ^ m_stable[index]) : 0;
+    }
+
+    // 把指定引脚的采样电平确认为稳定电平
+    void CommitStable(uint8_t index, uint16_t pins) {
+        if (index >= GPIO_PORT_COUNT) return;
+        m_stable[index] = (m_stable[index] & ~pins) | (m_snapshot[index] & pins);
+    }
+
+    /**
+     * @brief 设置引脚的消抖窗口（仅轮询引脚）
+     * @param ms 电平需保持稳定的时间（ms），0表示不消抖
+     * @return 引脚不在池中，或为EXTI引脚且ms非0时返回false：EXTI边沿在中断中直接投递，不经过消抖
+     */
+    bool SetDebounce(GPIO_TypeDef* port, uint16_t pin, uint16_t ms) {
+        GpioData* data = GetData(port, pin);
+        if (data == nullptr) return false;
+        if (ms != 0 && IsExtiMode(data->init_config.Mode)) return false;
+        data->debounce_ms = ms;
+        return true;
     }
 
     /**
@@ -135,49 +336,92 @@ public:
         }
         return GPIO_PIN_RESET;
     }
+
+    /**
+     * @brief 同一端口的多个引脚一次性置位/清零（单次BSRR写入，原子且无毛刺）
+     * @param set 需置1的引脚位图
+     * @param clear 需清0的引脚位图（与set重叠的引脚以set为准）
+     */
+    static inline void Write(GPIO_TypeDef* port, uint16_t set, uint16_t clear) {
+        port->BSRR = static_cast<uint32_t>(set) | (static_cast<uint32_t>(clear) << 16);
+    }
+
+    /**
+     * @brief 把mask内的引脚输出为value中对应位的电平，mask外的引脚不受影响
+     * @details 读-改-写式输出（如并行总线写一个字），仍只需一次BSRR写入
+     */
+    static inline void WriteMasked(GPIO_TypeDef* port, uint16_t mask, uint16_t value) {
+        Write(port, value & mask, ~value & mask);
+    }
+
+    /**
+     * @brief 翻转mask内的引脚
+     */
+    static inline void Toggle(GPIO_TypeDef* port, uint16_t mask) {
+        uint16_t odr = static_cast<uint16_t>(port->ODR);
+        Write(port, ~odr & mask, odr & mask);
+    }
+
+    /**
+     * @brief 编译期引脚组
+     * @tparam PortBase 端口基地址（如GPIOA_BASE）
+     * @tparam Mask 组内引脚位图
+     * @code using LcdCtrl = GPIO::PinGroup<GPIOA_BASE, GPIO_PIN_2 | GPIO_PIN_3>; LcdCtrl::Clear();
+     */
+    template<uintptr_t PortBase, uint16_t Mask>
+    struct PinGroup {
+        static_assert(Mask != 0, "引脚组不能为空");
+        static constexpr uint16_t mask = Mask;
+        static GPIO_TypeDef* Port() { return reinterpret_cast<GPIO_TypeDef*>(PortBase); }
+        static inline void Set() { Port()->BSRR = Mask; }
+        static inline void Clear() { Port()->BSRR = static_cast<uint32_t>(Mask) << 16; }
+        static inline void Write(uint16_t value) { GPIO::WriteMasked(Port(), Mask, value); }
+        static inline uint16_t Read() { return static_cast<uint16_t>(Port()->IDR) & Mask; }
+    };
     
+    /**
+     * @brief 引脚池范围（按添加顺序）：for (GpioData& data : gpio) { ... }
+     */
+    GpioData* begin() { return m_gpio_array.data(); }
+    GpioData* end() { return m_gpio_array.data() + m_count; }
+
     /**
      * @brief 遍历所有已添加的GPIO引脚
-     * @param callback 回调函数，参数为：端口、引脚号、GpioData指针
+     * @param callback 可调用对象，参数为：端口、引脚号、GpioData指针（模板参数，调用可内联）
      */
-    void ForEach(const std::function<void(GPIO_TypeDef*, uint16_t, GpioData*)>& callback) {
-        for (size_t i = 0; i < m_count; ++i) {
-            auto& data = m_gpio_array[i];
-            if (data) {
-                callback(data->port, data->init_config.Pin, data.get());
-            }
+    template<typename F>
+    void ForEach(F&& callback) {
+        for (GpioData& data : *this) {
+            callback(data.port, static_cast<uint16_t>(data.init_config.Pin), &data);
         }
     }
 
     /**
      * @brief 遍历指定端口的所有引脚
      * @param port 目标端口（如GPIOA）
-     * @param callback 回调函数，参数为：引脚号、GpioData指针
+     * @param callback 可调用对象，参数为：引脚号、GpioData指针
      */
-    void ForEachInPort(GPIO_TypeDef* port, const std::function<void(uint16_t, GpioData*)>& callback) {
-        if (port == nullptr) return;
-        ForEach([&](GPIO_TypeDef* curr_port, uint16_t pin, GpioData* data) {
-            if (curr_port == port) {
-                callback(pin, data);
-            }
-        });
+    template<typename F>
+    void ForEachInPort(GPIO_TypeDef* port, F&& callback) {
+        uint8_t index = port_index(port);
+        if (index >= GPIO_PORT_COUNT) return;
+        for (uint16_t pin : PinBits(m_used[index])) {
+            GpioData* data = slotData(index, pin);
+            if (data) callback(pin, data);  // 跳过Claim()登记、不在池中的引脚
+        }
     }
 
     /**
      * @brief 按条件查找GPIO引脚
-     * @param condition 条件函数（返回true表示匹配）
+     * @param condition 条件（返回true表示匹配），参数同ForEach
      * @return 第一个匹配的引脚数据（port, pin, data），无匹配则返回空
      */
-    std::tuple<GPIO_TypeDef*, uint16_t, GpioData*> FindIf(
-        const std::function<bool(GPIO_TypeDef*, uint16_t, GpioData*)>& condition
-    ) {
-        for (size_t i = 0; i < m_count; ++i) {
-            const auto& data_ptr = m_gpio_array[i];
-            if (!data_ptr) continue;
-            GPIO_TypeDef* port = data_ptr->port;
-            uint16_t pin = data_ptr->init_config.Pin;
-            if (condition(port, pin, data_ptr.get())) {
-                return {port, pin, data_ptr.get()};
+    template<typename F>
+    std::tuple<GPIO_TypeDef*, uint16_t, GpioData*> FindIf(F&& condition) {
+        for (GpioData& data : *this) {
+            uint16_t pin = static_cast<uint16_t>(data.init_config.Pin);
+            if (condition(data.port, pin, &data)) {
+                return {data.port, pin, &data};
             }
         }
         return {nullptr, 0, nullptr};
@@ -185,105 +429,109 @@ public:
 
     /**
      * @brief 初始化所有未初始化的GPIO引脚
+     * @return 有中断引脚的EXTI线已被其他端口占用时返回false（这些引脚保持未初始化，其余引脚照常初始化）
      */
-    void InitAll() {
-        ForEach([this](GPIO_TypeDef* port, uint16_t pin, GpioData* data) {
+    bool InitAll() {
+        bool ok = true;
+        ForEach([this, &ok](GPIO_TypeDef* port, uint16_t pin, GpioData* data) {
             if (!data->Gpio_initialized) {
-                if(data->port==GPIOA){
-                    if(!clock[0].first){
-                        __HAL_RCC_GPIOA_CLK_ENABLE();
-                        clock[0].first=true;
-                    }
-                    ++clock[0].second;
-                }
-                
-                if(data->port==GPIOB){
-                      if(!clock[1].first){
-                        __HAL_RCC_GPIOB_CLK_ENABLE();
-                        clock[1].first=true;
-                    }
-                    ++clock[1].second;
-                }
-                
-                if(data->port==GPIOC){
-                    if(!clock[2].first){
-                        __HAL_RCC_GPIOC_CLK_ENABLE();
-                        clock[2].first=true;
-                    }
-                    ++clock[2].second;
-                }
-
-                //Hardware init.
-                if(data->hardware_info.pwm_channel.htim.Instance==TIM1){
-                    if(!clock[3].first){
-                        __HAL_RCC_TIM1_CLK_ENABLE();
-                        clock[3].first=true;
-                    }
-                    ++clock[3].second;
-                }
-                if(data->hardware_info.pwm_channel.htim.Instance==TIM2){
-                    if(!clock[4].first){
-                        __HAL_RCC_TIM2_CLK_ENABLE();
-                        clock[4].first=true;
-                    }
-                    ++clock[4].second;
+                bool exti = IsExtiMode(data->init_config.Mode);
+                // HAL_GPIO_Init会改写AFIO_EXTICR，线已归属其他端口时不能初始化
+                if (exti && !ExtiLinesFree(port_index(port), pin)) {
+                    ok = false;
+                    return;
                 }
+                ForEachClock(*data, [](ClockId id) { ClockManager::Acquire(id); });
+                HAL_GPIO_Init(data->port, &data->init_config);
 
-                if(data->hardware_info.pwm_channel.htim.Instance==TIM3){
-                    if(!clock[5].first){
-                        __HAL_RCC_TIM3_CLK_ENABLE();
-                        clock[5].first=true;
-                    }
-                    ++clock[5].second;
-                }
-                if (data->hardware_info.i2c_channel.hi2c.Instance == I2C1) {
-                    if (!clock[6].first) {
-                        __HAL_RCC_I2C1_CLK_ENABLE();
-                        clock[6].first = true;
-                    }
-                    ++clock[6].second;
+                data->change_tick = HAL_GetTick();
+                data->Gpio_initialized = true;
+                if (exti) {
+                    EnableExti(port, pin);
+                } else {
+                    m_polled[port_index(port)] |= pin;
                 }
-                if(data->hardware_info.uart_channel.huart1.Instance==USART1){
-                    if (!clock[7].first) {
-                        __HAL_RCC_USART1_CLK_ENABLE();
-                        clock[7].first = true;
-                    }
-                    ++clock[7].second;
+            }
+        });
+        // 记录初始电平，避免上电后产生虚假边沿
+        for (uint8_t index = 0; index < GPIO_PORT_COUNT; ++index) {
+            if (m_polled[index] == 0) continue;
+            m_snapshot[index] = static_cast<uint16_t>(port_from_index(index)->IDR) & m_polled[index];
+            m_stable[index] = m_snapshot[index];
+        }
+        return ok;
+    }
 
-                }
-                 if(data->hardware_info.uart_channel.huart1.Instance==USART2){
-                    if (!clock[8].first) {
-                        __HAL_RCC_USART2_CLK_ENABLE();
-                        clock[8].first = true;
-                    }
-                    ++clock[8].second;
-                }
-                 if(data->hardware_info.spi_channel.hspi1.Instance==SPI1){
-                    if (!clock[9].first) {
-                        __HAL_RCC_SPI1_CLK_ENABLE();
-                        clock[9].first = true;
-                    }
-                    ++clock[9].second;
-                }
-                if(data->hardware_info.adc_channel.hadc.Instance==ADC1){
-                    if (!clock[10].first) {
-                        __HAL_RCC_ADC1_CLK_ENABLE();
-                        clock[10].first = true;
-                    }
-                    ++clock[10].second;
-                }
-                if(data->hardware_info.adc_channel.hadc.Instance==ADC2){
-                    if (!clock[11].first) {
-                        __HAL_RCC_ADC2_CLK_ENABLE();
-                        clock[11].first = true;
-                    }
-                    ++clock[11].second;
-                }
+    /**
+     * @brief 复位引脚配置并释放其占用的时钟（引脚所在的整组配置一起复位）
+     * @details 引脚仍保留在池中，之后可再次InitAll()；最后一个使用者释放时对应外设时钟被关闭
+     * @return 引脚不存在或未初始化返回false
+     */
+    bool DeInit(GPIO_TypeDef* port, uint16_t pin) {
+        GpioData* data = GetData(port, pin);
+        if (data == nullptr || !data->Gpio_initialized) return false;
+        uint8_t index = port_index(port);
+        uint16_t pins = static_cast<uint16_t>(data->init_config.Pin);
 
-                HAL_GPIO_Init(data->port, &data->init_config);
+        HAL_GPIO_DeInit(port, pins);
+        if (IsExtiMode(data->init_config.Mode)) {
+            for (uint16_t pin : PinBits(pins)) {
+                s_extiPort[__builtin_ctz(pin)] = nullptr;
+            }
+        }
+        m_polled[index] &= ~pins;
+        m_snapshot[index] &= ~pins;
+        m_stable[index] &= ~pins;
+        data->Gpio_initialized = false;
+        ForEachClock(*data, [](ClockId id) { ClockManager::Release(id); });
+        return true;
+    }
 
-                data->Gpio_initialized = true;
+    /**
+     * @brief 复位所有已初始化的引脚并释放时钟
+     */
+    void DeInitAll() {
+        ForEach([this](GPIO_TypeDef* port, uint16_t pin, GpioData* data) {
+            if (data->Gpio_initialized) {
+                DeInit(port, pin);
             }
         });
     }
+
+private:
+    static inline ExtiCallback s_extiCallback = nullptr;
+    static inline std::array<GPIO_TypeDef*, 16> s_extiPort{};  // EXTI线 → 端口
+
+    // 列出一组引脚配置需要的全部时钟：端口、所带外设、EXTI所需的AFIO
+    template<typename F>
+    static void ForEachClock(const GpioData& data, F&& f) {
+        f(static_cast<ClockId>(port_index(data.port)));
+        ClockId id = ClockManager::Find(data.hardware_info.instance());
+        if (id != ClockId::Count) f(id);
+        // EXTI线→端口映射写在AFIO_EXTICR中，需先开启AFIO时钟
+        if (IsExtiMode(data.init_config.Mode)) f(ClockId::Afio);
+    }
+
+    // 中断引脚的EXTI线未被其他端口占用（本对象已添加的引脚或已开启的EXTI线）
+    bool ExtiLinesFree(uint8_t index, uint16_t pins) const {
+        GPIO_TypeDef* port = port_from_index(index);
+        for (uint16_t pin : PinBits(pins)) {
+            uint8_t line = __builtin_ctz(pin);
+            if (m_extiOwner[line] != NO_SLOT && m_extiOwner[line] != index) return false;
+            if (s_extiPort[line] != nullptr && s_extiPort[line] != port) return false;
+        }
+        return true;
+    }
+
+    // 记录EXTI线所属端口并开启对应NVIC中断
+    static void EnableExti(GPIO_TypeDef* port, uint16_t pins) {
+        for (uint16_t pin : PinBits(pins)) {
+            uint8_t line = __builtin_ctz(pin);
+            s_extiPort[line] = port;
+            IRQn_Type irq = line <= 4 ? static_cast<IRQn_Type>(EXTI0_IRQn + line)
+                          : line <= 9 ? EXTI9_5_IRQn : EXTI15_10_IRQn;
+            HAL_NVIC_SetPriority(irq, GPIO_EXTI_PRIORITY, 0);
+            HAL_NVIC_EnableIRQ(irq);
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include "stm32f1xx_hal.h"
+
+// 端口下标换算只依赖GPIO_TypeDef与GPIOA~GPIOD，不引入外设通道，事件定义可在主机上编译
+
+static constexpr uint8_t GPIO_PORT_COUNT = 4;  // GPIOA~GPIOD
+
+/**
+ * @brief 端口→下标（GPIOA=0 ... GPIOD=3），未知端口返回GPIO_PORT_COUNT
+ */
+inline uint8_t port_index(GPIO_TypeDef* port) {
+    if (port == GPIOA) return 0;
+    if (port == GPIOB) return 1;
+    if (port == GPIOC) return 2;
+    if (port == GPIOD) return 3;
+    return GPIO_PORT_COUNT;
+}
+
+/**
+ * @brief 下标→端口，越界返回nullptr
+ */
+inline GPIO_TypeDef* port_from_index(uint8_t index) {
+    switch (index) {
+        case 0: return GPIOA;
+        case 1: return GPIOB;
+        case 2: return GPIOC;
+        case 3: return GPIOD;
+        default: return nullptr;
+    }
+}
+
+/**
+ * @brief HAL tick（ms）→GPIO边沿时间戳（us）
+ * @details EXTI与轮询两条路径都经此换算，按uint32_t取模，同在约71.6分钟（2^32us）处回绕；
+ *          比较先后或求间隔请用无符号减法（b - a），不要直接比较大小
+ */
+inline uint32_t tick_to_us(uint32_t ms) {
+    return ms * 1000u;
+}
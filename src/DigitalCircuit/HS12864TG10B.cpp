@@ -1,6 +1,9 @@
+#include <algorithm>
+#include <cstring>
 #include "HS12864TG10B.hpp"
+#ifndef UNIT_TEST
 #include "../Manager/Manager.hpp"
-#include "../Utils/Utils.hpp"
+#endif
 #include "stm32f1xx_hal.h"
 const uint8_t HS12864TG10B::ascii8x8[] = {
     // 0x20 空格（无变化）
@@ -195,21 +198,91 @@ const uint8_t HS12864TG10B::ascii8x8[] = {
     0x00,0x10,0x28,0x44,0x82,0x44,0x28,0x10,
 };
 
-HS12864TG10B::HS12864TG10B(GPIO_TypeDef* scl_port, uint16_t scl_pin,
-                           GPIO_TypeDef* sda_port, uint16_t sda_pin,
-                           GPIO_TypeDef* a0_port,  uint16_t a0_pin,
-                           GPIO_TypeDef* cs_port,  uint16_t cs_pin,
-                           GPIO_TypeDef* res_port, uint16_t res_pin)
-    : scl_port_(scl_port), scl_pin_(scl_pin),
-      sda_port_(sda_port), sda_pin_(sda_pin),
-      a0_port_(a0_port), a0_pin_(a0_pin),
-      cs_port_(cs_port), cs_pin_(cs_pin),
-      res_port_(res_port), res_pin_(res_pin) {}
+// 16x16汉字：每字前16字节为上半页16列，后16字节为下半页，低位在上
+const uint8_t HS12864TG10B::chinese16x16[][32] = {
+// U+4E00 一
+    {0x00,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x80,0x00,
+     0x00,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x01,0x00},
+    // U+4E09 三
+    {0x00,0x00,0x0C,0x0C,0x8C,0x8C,0x8C,0x8C,0x8C,0x8C,0x8C,0x8C,0x0C,0x0C,0x00,0x00,
+     0x00,0x30,0x30,0x30,0x31,0x31,0x31,0x31,0x31,0x31,0x31,0x31,0x30,0x30,0x30,0x00},
+    // U+4E0A 上
+    {0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0x30,0x30,0x30,0x30,0x30,0x30,0x00,0x00,
+     0x00,0x60,0x60,0x60,0x60,0x60,0x7F,0x7F,0x60,0x60,0x60,0x60,0x60,0x60,0x60,0x00},
+    // U+4E0B 下
+    {0x00,0x06,0x06,0x06,0x06,0x06,0x06,0xFE,0xFE,0x26,0x66,0x46,0xC6,0x86,0x06,0x00,
+     0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x7F,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    // U+4E2D 中
+    {0x00,0xFC,0xFC,0x84,0x84,0x84,0x84,0xFF,0xFF,0x84,0x84,0x84,0x84,0xFC,0xFC,0x00,
+     0x00,0x01,0x01,0x00,0x00,0x00,0x00,0xFF,0xFF,0x00,0x00,0x00,0x00,0x01,0x01,0x00},
+    // U+4E8C 二
+    {0x00,0x00,0x00,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x00,0x00,0x00,
+     0x00,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x18,0x00},
+    // U+5341 十
+    {0x00,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0xFF,0xFF,0xC0,0xC0,0xC0,0xC0,0xC0,0xC0,0x00,
+     0x00,0x00,0x00,0x00,0x00,0x00,0x00,0xFF,0xFF,0x00,0x00,0x00,0x00,0x00,0x00,0x00},
+    // U+53E3 口
+    {0x00,0x00,0xFC,0xFC,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0x04,0xFC,0xFC,0x00,0x00,
+     0x00,0x00,0x0F,0x0F,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x08,0x0F,0x0F,0x00,0x00},
+    // U+65E5 日
+    {0x00,0x00,0x00,0xFE,0xFE,0x42,0x42,0x42,0x42,0x42,0x42,0xFE,0xFE,0x00,0x00,0x00,
+     0x00,0x00,0x00,0x1F,0x1F,0x10,0x10,0x10,0x10,0x10,0x10,0x1F,0x1F,0x00,0x00,0x00},
+    // U+7530 田
+    {0x00,0xFE,0xFE,0x82,0x82,0x82,0x82,0x82,0xFE,0xFE,0x82,0x82,0x82,0xFE,0xFE,0x00,
+     0x00,0x3F,0x3F,0x20,0x20,0x20,0x20,0x20,0x3F,0x3F,0x20,0x20,0x20,0x3F,0x3F,0x00},
+};
+
+// 与chinese16x16一一对应，必须升序（二分查找）
+const uint16_t HS12864TG10B::chineseCode[] = {
+    0x4E00, 0x4E09, 0x4E0A, 0x4E0B, 0x4E2D, 0x4E8C, 0x5341, 0x53E3, 0x65E5, 0x7530,
+};
+
+const LcdFont HS12864TG10B::FONT_8X8 = {
+    ascii8x8, nullptr, nullptr, 0x20, 0x7E, 8, 8, 0, true, false,
+};
+
+const LcdFont HS12864TG10B::FONT_8X8_PROP = {
+    ascii8x8, nullptr, nullptr, 0x20, 0x7E, 8, 8, 1, true, true,
+};
+
+const LcdCjkFont HS12864TG10B::CJK_16X16 = {
+    chineseCode, chinese16x16,
+    static_cast<uint16_t>(sizeof(chineseCode) / sizeof(chineseCode[0])),
+};
+
+namespace {
+// 读取一个UTF-8字符并前移指针；非法序列按单字节返回U+FFFD
+uint32_t nextCodePoint(const char*& str) {
+    const uint8_t* s = reinterpret_cast<const uint8_t*>(str);
+    uint32_t code = s[0];
+    uint8_t extra = code < 0x80 ? 0 : (code >> 5) == 0x06 ? 1 : (code >> 4) == 0x0E ? 2 : (code >> 3) == 0x1E ? 3 : 0xFF;
+    if (extra == 0xFF) {
+        str++;
+        return 0xFFFD;
+    }
+    code &= 0x7F >> extra;
+    for (uint8_t i = 1; i <= extra; i++) {
+        if ((s[i] & 0xC0) != 0x80) {
+            str++;
+            return 0xFFFD;
+        }
+        code = (code << 6) | (s[i] & 0x3F);
+    }
+    str += extra + 1;
+    return code;
+}
+}  // namespace
+
+HS12864TG10B::HS12864TG10B(LcdTransport& transport, GPIO_TypeDef* res_port, uint16_t res_pin)
+    : transport_(&transport), res_port_(res_port), res_pin_(res_pin) {}
 
       void HS12864TG10B::init() {
+#ifndef UNIT_TEST
     if(!manager.initManager){
         return;
     }
+#endif
+    transport_->begin();
     hardwareReset();
     HAL_Delay(10);
     writeCmd(0xE3);  // 软件复位
@@ -228,6 +301,8 @@ HS12864TG10B::HS12864TG10B(GPIO_TypeDef* scl_port, uint16_t scl_pin,
     writeCmd(0xA6);  // 关闭反显
     HAL_Delay(10);
     writeCmd(0xA4);  // 取消全亮
+    start_line_ = 0;  // 复位后显示起始行为0
+    start_line_pending_ = false;
     clearScreen();  
     displayOn();
     HAL_Delay(50);
@@ -241,8 +316,38 @@ void HS12864TG10B::displayOff() {
 }
 
 void HS12864TG10B::clearScreen() {
-    memset(lcd_buffer, 0, sizeof(lcd_buffer));  // 清空缓冲区（1024字节）
-    refreshScreen();  // 刷新LCD显示
+    waitBuffer();
+    memset(draw_, 0, sizeof(lcd_buffer));  // 清空缓冲区（1024字节）
+    invalidate();     // 屏上内容未知，整屏重发
+    present();
+}
+
+void HS12864TG10B::invalidate() {
+    memset(dirty_cols_, 0xFF, sizeof(dirty_cols_));
+    dirty_pages_ = (1u << LCD_PAGE) - 1;
+}
+
+void HS12864TG10B::markDirty(uint8_t page, uint8_t x) {
+    dirty_cols_[page][x >> 5] |= 1u << (x & 31);
+    dirty_pages_ |= 1u << page;
+}
+
+bool HS12864TG10B::isDirty(uint8_t page, uint8_t x) const {
+    return (dirty_cols_[page][x >> 5] >> (x & 31)) & 1u;
+}
+
+// 单缓冲时绘制前需等后台传输读完缓冲区；双缓冲时绘制缓冲不会被传输读取
+void HS12864TG10B::waitBuffer() {
+#ifndef _LcdDoubleBuffer
+    transport_->wait();
+#endif
+}
+
+void HS12864TG10B::setByte(uint8_t page, uint8_t x, uint8_t value) {
+    if (draw_[page][x] == value) return;  // 内容未变，不必重发
+    waitBuffer();
+    draw_[page][x] = value;
+    markDirty(page, x);
 }
 
 void HS12864TG10B::turnOnAllPixel() {
@@ -265,30 +370,8 @@ uint8_t HS12864TG10B::reverseBit(uint8_t data) {
 }
 
 void HS12864TG10B::writeCmd(uint8_t cmd) {
-    HAL_GPIO_WritePin(cs_port_, cs_pin_, GPIO_PIN_RESET);  // 使能CS
-    HAL_GPIO_WritePin(a0_port_, a0_pin_, GPIO_PIN_RESET);  // 指令模式（A0=0）
-    for (uint8_t i = 0; i < 8; i++) {
-        writeBit((cmd >> (7 - i)) & 0x01);  // 高位先传
-    }
-    HAL_GPIO_WritePin(cs_port_, cs_pin_, GPIO_PIN_SET);  // 禁用CS
-}
-
-void HS12864TG10B::writeBit(uint8_t bit) {
-    HAL_GPIO_WritePin(sda_port_, sda_pin_, bit ? GPIO_PIN_SET : GPIO_PIN_RESET);
-    Utils::HAL_Delay_us(1); 
-    HAL_GPIO_WritePin(scl_port_, scl_pin_, GPIO_PIN_SET);
-    Utils::HAL_Delay_us(1);
-    HAL_GPIO_WritePin(scl_port_, scl_pin_, GPIO_PIN_RESET);
-    Utils::HAL_Delay_us(1);
-}
-
-void HS12864TG10B::writeData(uint8_t dat) {
-    HAL_GPIO_WritePin(cs_port_, cs_pin_, GPIO_PIN_RESET);  // 使能CS
-    HAL_GPIO_WritePin(a0_port_, a0_pin_, GPIO_PIN_SET);    // 数据模式
-    for (uint8_t i = 0; i < 8; i++) {
-        writeBit((dat >> (7 - i)) & 0x01);  // 高位先传
-    }
-    HAL_GPIO_WritePin(cs_port_, cs_pin_, GPIO_PIN_SET);  // 禁用CS
+    transport_->send(false, &cmd, 1);
+    transport_->flush();
 }
 
 void HS12864TG10B::hardwareReset() {
@@ -300,9 +383,17 @@ void HS12864TG10B::hardwareReset() {
 
 void HS12864TG10B::setCursor(uint8_t x, uint8_t y) {
     if (x >= LCD_WIDTH || y >= 8) return;  // 越界保护
-    writeCmd(0xB0 + y);                  // 设置页地址（规格书9.1-3）
-    writeCmd(0x10 + ((x >> 4) & 0x0F));  // 列地址高位（x的高4位）
-    writeCmd(0x00 + (x & 0x0F));        // 列地址低位（x的低4位）
+    uint8_t page = 0xB0 + y;             // 设置页地址（规格书9.1-3）
+    transport_->send(false, &page, 1);
+    setColumn(x);
+}
+
+void HS12864TG10B::setColumn(uint8_t x) {
+    uint8_t cmd[2] = {
+        static_cast<uint8_t>(0x10 + ((x >> 4) & 0x0F)),  // 列地址高位（x的高4位）
+        static_cast<uint8_t>(0x00 + (x & 0x0F)),         // 列地址低位（x的低4位）
+    };
+    transport_->send(false, cmd, 2);
 }
 
 uint8_t HS12864TG10B::getPage(uint8_t y) {
@@ -315,68 +406,425 @@ uint8_t HS12864TG10B::getPageOffset(uint8_t y) {
 
 void HS12864TG10B::showAscii(uint8_t x, uint8_t y_page, char ch, uint8_t color) {
     if (x >= LCD_WIDTH || y_page >= LCD_PAGE || ch < 0x20 || ch > 0x7E) return;
-    uint8_t char_index = (ch - 0x20) * 8;  // 正确字库索引
-    for (uint8_t col = 7; col != 0xFF; col--) {  
-        uint8_t curr_x = x + (7 - col);  // 列坐标：col7→x+0（左），col0→x+7（右）
-        if (curr_x >= LCD_WIDTH) break;
-        uint8_t char_data = ascii8x8[char_index + col];  // 反向取列数据（匹配字库）
-        if (color == 0) char_data = ~char_data;  // 反色控制（默认不用）
-        lcd_buffer[y_page][curr_x] = char_data;
-    }
-    
-    refreshScreen();
+    blitGlyph(x, y_page * 8, findGlyph(static_cast<uint8_t>(ch), FONT_8X8), color);
+    present();
 }
 void HS12864TG10B::showAsciiStr(uint8_t x_start, uint8_t y_page, const char* str, uint8_t color) {
     if (str == nullptr || x_start >= LCD_WIDTH || y_page >= LCD_PAGE) return;
     
+    beginFrame();  // 整串字符一次刷新
     uint8_t curr_x = x_start; 
     for (uint8_t i = 0; str[i] != '\0'; i++) {
         if (curr_x + 8 > LCD_WIDTH) break;
         showAscii(curr_x, y_page, str[i], color);
         curr_x += 8;
     }
-    refreshScreen();
+    endFrame();
+}
+
+void HS12864TG10B::setFont(const LcdFont& font, const LcdCjkFont* cjk) {
+    font_ = &font;
+    cjk_ = cjk;
+}
+
+HS12864TG10B::Glyph HS12864TG10B::findGlyph(uint32_t code, const LcdFont& font) const {
+    bool proportional = font.trim || font.widths != nullptr;
+    uint8_t blank = proportional ? font.width / 2 : font.width;  // 无字形/空格的前进列数
+    if (!font.contains(code)) {
+        const uint8_t* cjk = (code >= 0x80 && cjk_) ? cjk_->find(code) : nullptr;
+        if (cjk) return {cjk, LcdCjkFont::SIZE, LcdCjkFont::SIZE, 0, LcdCjkFont::SIZE, false};
+        return {nullptr, 0, 0, 0, code >= 0x80 && cjk_ ? LcdCjkFont::SIZE : blank, false};
+    }
+    uint8_t index = static_cast<uint8_t>(code - font.first);
+    uint8_t width = font.widths ? font.widths[index] : font.width;
+    const uint8_t* data = font.bitmap + (font.offsets ? font.offsets[index] : index * font.pages() * font.width);
+    Glyph glyph = {data, width, font.height, 0, width, font.reversed};
+    if (font.trim) {
+        uint8_t left = width, right = 0;
+        for (uint8_t c = 0; c < width; c++) {
+            uint8_t ink = 0;
+            for (uint8_t p = 0; p < font.pages(); p++) {
+                ink |= data[p * width + (font.reversed ? width - 1 - c : c)];
+            }
+            if (ink) {
+                left = std::min(left, c);
+                right = c;
+            }
+        }
+        if (left > right) return {data, width, font.height, width, blank, font.reversed};  // 空格：只清背景
+        glyph.first = left;
+        glyph.advance = right - left + 1;
+    }
+    if (proportional) glyph.advance += font.spacing;
+    return glyph;
+}
+
+void HS12864TG10B::blitGlyph(int16_t x, int16_t y, const Glyph& glyph, uint8_t color) {
+    if (glyph.data == nullptr || x >= LCD_WIDTH || x + glyph.advance <= 0 ||
+        y >= LCD_HEIGHT || y + glyph.height <= 0) return;
+    // 只保留落在逻辑行0~63内的字形行，再按起始行映射到显存（页号对8取模即环形）
+    int16_t lo = y < 0 ? -y : 0;
+    int16_t hi = std::min<int16_t>(glyph.height, LCD_HEIGHT - y);
+    uint8_t row = (y + start_line_) & (LCD_HEIGHT - 1);
+    uint8_t page0 = row >> 3;
+    uint8_t shift = row & 7;
+    uint8_t pages = (glyph.height + 7) / 8;
+    uint32_t mask = (((1u << hi) - 1) & ~((1u << lo) - 1)) << shift;
+
+    waitBuffer();
+    for (uint8_t i = 0; i < glyph.advance; i++) {
+        int16_t cx = x + i;
+        if (cx < 0) continue;
+        if (cx >= LCD_WIDTH) break;
+        uint8_t c = glyph.first + i;
+        uint32_t bits = 0;
+        if (c < glyph.stride) {
+            uint8_t src = glyph.reversed ? glyph.stride - 1 - c : c;
+            for (uint8_t p = 0; p < pages; p++) {
+                bits |= static_cast<uint32_t>(glyph.data[p * glyph.stride + src]) << (8 * p);
+            }
+        }
+        bits = (bits << shift) & mask;
+        if (!color) bits ^= mask;
+        for (uint8_t p = 0; p * 8 < shift + glyph.height; p++) {
+            uint8_t page = (page0 + p) & (LCD_PAGE - 1);
+            uint8_t m = static_cast<uint8_t>(mask >> (8 * p));
+            uint8_t value = (draw_[page][cx] & ~m) | static_cast<uint8_t>(bits >> (8 * p));
+            if (value != draw_[page][cx]) {
+                draw_[page][cx] = value;
+                markDirty(page, cx);
+            }
+        }
+    }
+}
+
+uint8_t HS12864TG10B::drawChar(int16_t x, int16_t y, uint32_t code, uint8_t color) {
+    Glyph glyph = findGlyph(code, *font_);
+    blitGlyph(x, y, glyph, color);
+    present();
+    return glyph.advance;
+}
+
+int16_t HS12864TG10B::drawString(int16_t x, int16_t y, const char* str, uint8_t color) {
+    if (str == nullptr) return x;
+    beginFrame();  // 整串写入缓冲区，最后统一刷新
+    int16_t cx = x;
+    uint8_t line_height = font_->height;
+    while (*str) {
+        uint32_t code = nextCodePoint(str);
+        if (code == '\n') {
+            cx = x;
+            y += line_height;
+            line_height = font_->height;
+            continue;
+        }
+        Glyph glyph = findGlyph(code, *font_);
+        blitGlyph(cx, y, glyph, color);
+        line_height = std::max(line_height, glyph.height);
+        cx += glyph.advance;
+    }
+    endFrame();
+    return cx;
+}
+
+uint16_t HS12864TG10B::textWidth(const char* str) const {
+    uint16_t width = 0, line = 0;
+    while (str && *str) {
+        uint32_t code = nextCodePoint(str);
+        line = code == '\n' ? 0 : line + findGlyph(code, *font_).advance;
+        width = std::max(width, line);
+    }
+    return width;
+}
+
+uint8_t HS12864TG10B::physicalRow(int16_t y) const {
+    return (y + start_line_) & (LCD_HEIGHT - 1);
+}
+
+void HS12864TG10B::setStartLine(uint8_t line) {
+    line &= LCD_HEIGHT - 1;
+    if (line == start_line_) return;
+    start_line_ = line;
+    start_line_pending_ = true;
+    present();
+}
+
+/**
+ * @brief 画面整体上移rows行：只改显示起始行，显存内容不搬动
+ * @details 移入底部的rows行就是刚移出顶部的显存行，按fill清空后只有内容变化的列被重发
+ */
+void HS12864TG10B::scroll(uint8_t rows, uint8_t fill) {
+    if (rows == 0) return;
+    if (rows > LCD_HEIGHT) rows = LCD_HEIGHT;
+    beginFrame();
+    start_line_ = (start_line_ + rows) & (LCD_HEIGHT - 1);
+    start_line_pending_ = true;
+    fillArea(0, LCD_HEIGHT - rows, LCD_WIDTH - 1, LCD_HEIGHT - 1, fill);
+    endFrame();
+}
+
+void HS12864TG10B::beginConsole(uint8_t line_height) {
+    console_line_ = line_height ? line_height : font_->height;
+    console_x_ = 0;
+    console_y_ = 0;
+    clearScreen();
+}
+
+// 换行：未到底部时下移一行，到底后硬件滚动一行
+void HS12864TG10B::consoleNewLine() {
+    console_x_ = 0;
+    if (console_y_ + 2 * console_line_ <= LCD_HEIGHT) {
+        console_y_ += console_line_;
+    } else {
+        scroll(console_line_);
+    }
+}
+
+void HS12864TG10B::consoleWrite(const char* str, uint8_t color) {
+    if (str == nullptr) return;
+    beginFrame();
+    while (*str) {
+        uint32_t code = nextCodePoint(str);
+        if (code == '\n') {
+            consoleNewLine();
+            continue;
+        }
+        if (code == '\r') {
+            console_x_ = 0;
+            continue;
+        }
+        Glyph glyph = findGlyph(code, *font_);
+        if (console_x_ + glyph.advance > LCD_WIDTH) consoleNewLine();  // 自动折行
+        blitGlyph(console_x_, console_y_, glyph, color);
+        console_x_ += glyph.advance;
+    }
+    endFrame();
+}
+
+void HS12864TG10B::consoleSink(void* lcd, const char* text) {
+    static_cast<HS12864TG10B*>(lcd)->consoleWrite(text);
+}
+
+/**
+ * @brief 滚动曲线：每个采样上移一行，在底行画出与上一采样相连的水平段
+ * @param value 采样对应的列（0-127），时间轴向上
+ */
+void HS12864TG10B::chartPush(uint8_t value, uint8_t color) {
+    if (value >= LCD_WIDTH) value = LCD_WIDTH - 1;
+    beginFrame();
+    scroll(1, color ? 0 : 1);
+    uint8_t from = chart_last_ < LCD_WIDTH ? chart_last_ : value;
+    hspan(from, value, LCD_HEIGHT - 1, color);
+    chart_last_ = value;
+    endFrame();
 }
 
+void HS12864TG10B::chartReset() {
+    chart_last_ = 0xFF;
+}
+
+/**
+ * @brief 局部刷新：逐页找出脏列段，段间用列地址指令跳转，只发送改动过的字节
+ * @details 每段显示数据作为一整段交给transport_，A0只在指令/数据之间切换一次
+ * @details 间隔不超过LCD_REFRESH_GAP的两段合并发送，比跳列更省。
+ *          传输队列有上限（capacity()非0，如DMA）时每页只发一段（首个到最后一个脏列），
+ *          整次刷新最多1+2*LCD_PAGE段，排队不会因队列满而阻塞CPU。
+ *          双缓冲时先交换前后台指针，发送新前台的脏列，同时把这些列拷回后台，
+ *          使后台与屏幕内容一致；上一帧尚未发完时本次跳过，改动保留到下一次
+ */
 void HS12864TG10B::refreshScreen() {
-    // 原错误：page < LCD_HEIGHT（64），改为page < LCD_PAGE（8）
-    for (uint8_t page = 0; page < LCD_PAGE; page++) {  
-        setCursor(0, page);  // 定位到当前页第0列
-        for (uint8_t x = 0; x < LCD_WIDTH; x++) {
-            writeData(lcd_buffer[page][x]);  // 写入当前页所有列数据
+#ifdef _LcdDoubleBuffer
+    if (transport_->busy() || (dirty_pages_ == 0 && !start_line_pending_)) return;
+    std::swap(draw_, front_);
+#endif
+    if (start_line_pending_) {  // 起始行指令与新行数据同一次flush发送
+        uint8_t cmd = 0x40 | start_line_;
+        transport_->send(false, &cmd, 1);
+        start_line_pending_ = false;
+    }
+    // 有队列上限时整页合并为一段：多发的几个字节由DMA在后台完成
+    uint8_t gap = transport_->capacity() != 0 ? LCD_WIDTH : LCD_REFRESH_GAP;
+    for (uint8_t page = 0; page < LCD_PAGE; page++) {
+        if (!(dirty_pages_ & (1u << page))) continue;
+        bool page_set = false;
+        uint8_t column = LCD_WIDTH;  // 控制器当前列地址（写数据后自动+1）
+        uint8_t x = 0;
+        while (x < LCD_WIDTH) {
+            if (!isDirty(page, x)) {
+                x++;
+                continue;
+            }
+            uint8_t start = x, end = x;
+            for (uint8_t i = x + 1; i < LCD_WIDTH && i - end <= gap + 1; i++) {
+                if (isDirty(page, i)) end = i;
+            }
+            if (!page_set) {
+                setCursor(start, page);
+                page_set = true;
+            } else if (column != start) {
+                setColumn(start);
+            }
+            uint8_t len = end - start + 1;
+            transport_->send(true, &front_[page][start], len);
+            if (draw_ != front_) {
+                memcpy(&draw_[page][start], &front_[page][start], len);
+            }
+            column = end + 1;
+            x = end + 1;
         }
-        Utils::HAL_Delay_us(50);
+        memset(dirty_cols_[page], 0, sizeof(dirty_cols_[page]));
     }
+    dirty_pages_ = 0;
+    transport_->flush();  // DMA通道下立即返回，传输在后台完成
+    last_flush_ = HAL_GetTick();
+}
+
+void HS12864TG10B::beginFrame() {
+    ++frame_depth_;
+}
+
+void HS12864TG10B::endFrame() {
+    if (frame_depth_ == 0) return;
+    if (--frame_depth_ == 0) {
+        refreshScreen();
+    }
+}
+
+void HS12864TG10B::setFrameInterval(uint16_t ms) {
+    frame_interval_ = ms;
+}
+
+void HS12864TG10B::update() {
+    if (frame_depth_ == 0 && (dirty_pages_ != 0 || start_line_pending_) &&
+        HAL_GetTick() - last_flush_ >= frame_interval_) {
+        refreshScreen();
+    }
+}
+
+/**
+ * @brief 单个绘制函数结束：帧内只留在缓冲区；帧外按刷新间隔决定立即刷新还是交给update()
+ */
+void HS12864TG10B::present() {
+    if (frame_depth_ != 0) return;
+    if (frame_interval_ != 0 && HAL_GetTick() - last_flush_ < frame_interval_) return;
+    refreshScreen();
 }
 
 void HS12864TG10B::drawPoint(uint8_t x, uint8_t y, uint8_t color) {
     if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
     
+    y = physicalRow(y);                 // 滚动后逻辑行→显存行
     uint8_t page = getPage(y);          // 计算页（0~7）
     uint8_t offset = getPageOffset(y);  // 计算页内bit偏移（0~7）
     
     if (color == 1) {
         // 点亮：置位对应bit（不影响其他bit）
-        lcd_buffer[page][x] |= (1 << offset);
+        setByte(page, x, draw_[page][x] | (1 << offset));
     } else {
         // 熄灭：清0对应bit
-        lcd_buffer[page][x] &= ~(1 << offset);
+        setByte(page, x, draw_[page][x] & ~(1 << offset));
     }
 }
 // 新增：专用垂直直线绘制（x固定为50，y从y1到y2，避免setCursor计算偏差）
 void HS12864TG10B::drawVerticalLine(uint8_t y1, uint8_t y2, uint8_t color) {
     const uint8_t fixed_x = 50;  // 固定x=50（垂直直线）
-    if (y1 > y2) std::swap(y1, y2);  // 确保y1≤y2（避免反向遍历）
-    
-    // 遍历所有y值，修改缓冲区（fixed_x被使用，警告消失）
-    for (uint8_t y = y1; y <= y2; y++) {
-        drawPoint(fixed_x, y, color);  // 调用缓冲区画点
+    vspan(fixed_x, y1, y2, color);
+    present();  // 刷新LCD显示
+}
+
+/**
+ * @brief 矩形区域填充：逐页生成行掩码，每列字节只做一次按位或/与
+ * @details 中间页掩码为0xFF（整字节写入），首尾页各自带掩码；坐标越界部分被裁剪
+ */
+void HS12864TG10B::fillArea(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color) {
+    if (x1 > x2) std::swap(x1, x2);
+    if (y1 > y2) std::swap(y1, y2);
+    if (x2 < 0 || y2 < 0 || x1 >= LCD_WIDTH || y1 >= LCD_HEIGHT) return;
+    if (x1 < 0) x1 = 0;
+    if (y1 < 0) y1 = 0;
+    if (x2 >= LCD_WIDTH) x2 = LCD_WIDTH - 1;
+    if (y2 >= LCD_HEIGHT) y2 = LCD_HEIGHT - 1;
+    if (start_line_ != 0) {  // 滚动后逻辑行映射到显存行，跨过环形缓冲末尾时拆成两段
+        int16_t top = physicalRow(y1), bottom = physicalRow(y2);
+        if (top > bottom) {
+            fillRows(x1, top, x2, LCD_HEIGHT - 1, color);
+            top = 0;
+        }
+        fillRows(x1, top, x2, bottom, color);
+        return;
     }
-    
-    refreshScreen();  // 刷新LCD显示
+    fillRows(x1, y1, x2, y2, color);
+}
+
+// 按显存行填充（坐标已裁剪）
+void HS12864TG10B::fillRows(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color) {
+    waitBuffer();
+    uint8_t first = y1 >> 3, last = y2 >> 3;
+    for (uint8_t page = first; page <= last; page++) {
+        uint8_t mask = 0xFF;
+        if (page == first) mask &= static_cast<uint8_t>(0xFF << (y1 & 7));
+        if (page == last) mask &= static_cast<uint8_t>(0xFF >> (7 - (y2 & 7)));
+        uint8_t set = color ? mask : 0;
+        uint8_t* row = draw_[page];
+        const uint32_t mask4 = mask * 0x01010101u, set4 = set * 0x01010101u;
+        // 按32列一块处理：块内无分支（总是回写），有变化的列按字批量标脏
+        for (int16_t x = x1; x <= x2;) {
+            int16_t end = std::min<int16_t>(x2, x | 31);
+            uint8_t word = x >> 5;
+            uint32_t changed = 0;
+            for (; x <= end && (x & 3); x++) {  // 对齐到4列
+                uint8_t value = (row[x] & ~mask) | set;
+                changed |= static_cast<uint32_t>(value != row[x]) << (x & 31);
+                row[x] = value;
+            }
+            for (; x + 3 <= end; x += 4) {  // 一次处理4列（32位读写）
+                uint32_t old, value;
+                memcpy(&old, row + x, 4);
+                value = (old & ~mask4) | set4;
+                memcpy(row + x, &value, 4);
+                uint32_t diff = old ^ value;  // 每字节非0即该列有变化，压缩成4个标志位
+                diff |= diff >> 4;
+                diff |= diff >> 2;
+                diff |= diff >> 1;
+                changed |= (((diff & 0x01010101u) * 0x10204080u) >> 28) << (x & 31);
+            }
+            for (; x <= end; x++) {
+                uint8_t value = (row[x] & ~mask) | set;
+                changed |= static_cast<uint32_t>(value != row[x]) << (x & 31);
+                row[x] = value;
+            }
+            if (changed) {
+                dirty_cols_[page][word] |= changed;
+                dirty_pages_ |= 1u << page;
+            }
+        }
+    }
+}
+
+void HS12864TG10B::hspan(int16_t x1, int16_t x2, int16_t y, uint8_t color) {
+    fillArea(x1, y, x2, y, color);
+}
+
+void HS12864TG10B::vspan(int16_t x, int16_t y1, int16_t y2, uint8_t color) {
+    fillArea(x, y1, x, y2, color);
+}
+
+void HS12864TG10B::drawHLine(uint8_t x1, uint8_t x2, uint8_t y, uint8_t color) {
+    hspan(x1, x2, y, color);
+    present();
+}
+
+void HS12864TG10B::drawVLine(uint8_t x, uint8_t y1, uint8_t y2, uint8_t color) {
+    vspan(x, y1, y2, color);
+    present();
 }
 
 void HS12864TG10B::drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color) {
+    if (y1 == y2 || x1 == x2) {  // 水平/垂直线走扫描线
+        fillArea(x1, y1, x2, y2, color);
+        present();
+        return;
+    }
     int16_t dx = x2 - x1;  // x方向差值
     int16_t dy = y2 - y1;  // y方向差值
     int16_t sx = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;  // x步长
@@ -401,7 +849,7 @@ void HS12864TG10B::drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint
             y += sy;
         }
     }
-    refreshScreen();  // 绘制完成后刷新
+    present();  // 绘制完成后刷新
 }
 
 void HS12864TG10B::drawTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint8_t color) {
@@ -409,42 +857,32 @@ void HS12864TG10B::drawTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2,
         return (x < LCD_WIDTH) && (y < LCD_HEIGHT);
     };
     if (!isCoordValid(x1,y1) && !isCoordValid(x2,y2) && !isCoordValid(x3,y3)) return;
+    beginFrame();  // 三条边一次刷新
     drawLine(x1, y1, x2, y2, color);
     drawLine(x2, y2, x3, y3, color);
     drawLine(x3, y3, x1, y1, color);
+    endFrame();
 }
 void HS12864TG10B::drawRect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color, bool fill) {
  
     if (x1 > x2) std::swap(x1, x2);  // 交换x，确保左上角x≤右下角x
     if (y1 > y2) std::swap(y1, y2);  // 交换y，确保左上角y≤右下角y
-    x1 = (x1 < 0) ? 0 : x1;
-    x2 = (x2 > 127) ? 127 : x2;
-    y1 = (y1 < 0) ? 0 : y1;
+    x2 = (x2 > 127) ? 127 : x2;  // 坐标无符号，只需裁剪右下角
     y2 = (y2 > 63) ? 63 : y2;
 
     if (fill) {
-        for (uint8_t y = y1; y <= y2; y++) {  // 遍历y从y1到y2（垂直方向）
-            for (uint8_t x = x1; x <= x2; x++) {  // 遍历x从x1到x2（水平方向）
-                drawPoint(x, y, color);
-            }
-        }
+        fillArea(x1, y1, x2, y2, color);
     } 
     else {
-        for (uint8_t x = x1; x <= x2; x++) {
-            drawPoint(x, y1, color);
-        }
-        for (uint8_t x = x1; x <= x2; x++) {
-            drawPoint(x, y2, color);
-        }
-        for (uint8_t y = y1 + 1; y < y2; y++) {
-            drawPoint(x1, y, color);
-        }
-        for (uint8_t y = y1 + 1; y < y2; y++) {
-            drawPoint(x2, y, color);
+        hspan(x1, x2, y1, color);
+        hspan(x1, x2, y2, color);
+        if (y2 > y1 + 1) {
+            vspan(x1, y1 + 1, y2 - 1, color);
+            vspan(x2, y1 + 1, y2 - 1, color);
         }
     }
 
-    refreshScreen();
+    present();
 }
 
 void HS12864TG10B::drawCircle8Points(uint8_t x0, uint8_t y0, uint8_t x, uint8_t y, uint8_t color) {
@@ -487,5 +925,103 @@ void HS12864TG10B::drawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint8_t color)
         x++;  // x始终+1
     }
 
-    refreshScreen();  // 刷新LCD
-}
\ No newline at end of file
+    present();  // 刷新LCD
+}
+
+void HS12864TG10B::fillCircle(uint8_t x0, uint8_t y0, uint8_t r, uint8_t color) {
+    int16_t x = 0;
+    int16_t y = r;
+    int16_t d = 3 - 2 * r;
+    // 与drawCircle相同的中点算法，每步画4条对称的垂直扫描线
+    while (x <= y) {
+        vspan(x0 + x, y0 - y, y0 + y, color);
+        vspan(x0 - x, y0 - y, y0 + y, color);
+        vspan(x0 + y, y0 - x, y0 + x, color);
+        vspan(x0 - y, y0 - x, y0 + x, color);
+        if (d < 0) {
+            d += 4 * x + 6;
+        } else {
+            d += 4 * (x - y) + 10;
+            y--;
+        }
+        x++;
+    }
+    present();
+}
+
+void HS12864TG10B::fillTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint8_t color) {
+    const int16_t px[3] = {x1, x2, x3};
+    const int16_t py[3] = {y1, y2, y3};
+    int16_t min_x = std::min<int16_t>(x1, std::min(x2, x3));
+    int16_t max_x = std::max<int16_t>(x1, std::max(x2, x3));
+    // 逐列取三条边在该列上的y范围的并集，得到一条垂直扫描线
+    for (int16_t x = min_x; x <= max_x; x++) {
+        int16_t lo = LCD_HEIGHT, hi = -1;
+        for (uint8_t e = 0; e < 3; e++) {
+            int16_t xa = px[e], ya = py[e];
+            int16_t xb = px[(e + 1) % 3], yb = py[(e + 1) % 3];
+            if (xa > xb) {
+                std::swap(xa, xb);
+                std::swap(ya, yb);
+            }
+            if (x < xa || x > xb) continue;
+            int16_t top, bottom;
+            if (xa == xb) {  // 垂直边：整段都在该列
+                top = std::min(ya, yb);
+                bottom = std::max(ya, yb);
+            } else {
+                // 取该列左右半像素处的y，陡边在一列内覆盖多行（与drawLine的点一致）
+                int32_t den = 2 * (xb - xa);
+                auto yAt = [&](int32_t twice_dx) -> int16_t {
+                    if (twice_dx < 0) twice_dx = 0;
+                    if (twice_dx > den) twice_dx = den;
+                    int32_t num = static_cast<int32_t>(yb - ya) * twice_dx;
+                    int32_t half = num >= 0 ? den / 2 : -den / 2;  // 四舍五入
+                    return ya + static_cast<int16_t>((num + half) / den);
+                };
+                int16_t left = yAt(2 * (x - xa) - 1), right = yAt(2 * (x - xa) + 1);
+                top = std::min(left, right);
+                bottom = std::max(left, right);
+            }
+            if (top < lo) lo = top;
+            if (bottom > hi) hi = bottom;
+        }
+        if (lo <= hi) vspan(x, lo, hi, color);
+    }
+    present();
+}
+
+void HS12864TG10B::drawThickLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t width, uint8_t color) {
+    if (width <= 1) {
+        drawLine(x1, y1, x2, y2, color);
+        return;
+    }
+    int16_t dx = x2 - x1, dy = y2 - y1;
+    int16_t sx = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;
+    int16_t sy = (dy > 0) ? 1 : (dy < 0) ? -1 : 0;
+    dx = (dx < 0) ? -dx : dx;
+    dy = (dy < 0) ? -dy : dy;
+    bool steep = dy > dx;          // 陡线横向加宽，平线纵向加宽
+    int16_t before = (width - 1) / 2, after = width / 2;
+
+    int16_t err = dx - dy;
+    int16_t x = x1, y = y1;
+    while (1) {
+        if (steep) {
+            hspan(x - before, x + after, y, color);
+        } else {
+            vspan(x, y - before, y + after, color);
+        }
+        if (x == x2 && y == y2) break;
+        int16_t err2 = 2 * err;
+        if (err2 > -dy) {
+            err -= dy;
+            x += sx;
+        }
+        if (err2 < dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+    present();
+}
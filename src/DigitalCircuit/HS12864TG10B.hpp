@@ -1,29 +1,95 @@
 #pragma once
 #include "stm32f1xx_hal.h"
+#include "LcdBus.hpp"
+#include "LcdFont.hpp"
 
 #define LCD_WIDTH  128    // 列数（0-127）
 #define LCD_HEIGHT 64    // 行数（0-63）
 #define LCD_PAGE   8     // 页数（64行 ÷ 8行/页 = 8页）  // 新增页定义
+#ifndef LCD_REFRESH_GAP
+#define LCD_REFRESH_GAP 2  // 两段脏列间隔不超过该值时合并发送（跳列需2字节列地址指令）
+#endif
 
 class HS12864TG10B {
 public:
-    HS12864TG10B(GPIO_TypeDef* scl_port, uint16_t scl_pin,
-                 GPIO_TypeDef* sda_port, uint16_t sda_pin,
-                 GPIO_TypeDef* a0_port,  uint16_t a0_pin,
-                 GPIO_TypeDef* cs_port,  uint16_t cs_pin,
-                 GPIO_TypeDef* res_port, uint16_t res_pin);
+    /**
+     * @param transport 串行总线（BitBangTransport或Spi1DmaTransport），生命周期需长于驱动
+     */
+    HS12864TG10B(LcdTransport& transport, GPIO_TypeDef* res_port, uint16_t res_pin);
     void init();                  // 完整初始化（复位+指令配置）
     void displayOn();             // 开启显示
     void displayOff();            // 关闭显示
     void clearScreen();           // 清屏（填充黑色）
     void turnOnAllPixel();        // 强制全亮（测试用）
-    void refreshScreen();
+    void refreshScreen();         // 只发送自上次刷新以来改动过的列
+    void invalidate();            // 标记整屏为脏（下次refreshScreen()全屏发送）
+
+    /**
+     * @brief 帧事务：beginFrame()/endFrame()之间的绘制只写缓冲区，最外层endFrame()统一刷新一次
+     * @details 可嵌套；也可用RAII：{ HS12864TG10B::Frame frame(lcd); lcd.drawRect(...); ... }
+     */
+    void beginFrame();
+    void endFrame();
+
+    /**
+     * @brief 帧外绘制的最小刷新间隔（ms），0=每个绘制函数结束立即刷新（默认）
+     * @details 间隔未到的改动留在缓冲区，由update()在到期后一次发出
+     */
+    void setFrameInterval(uint16_t ms);
+    void update();                // 主循环调用：刷新间隔到期且有改动时刷新
+
+    class Frame {
+    public:
+        explicit Frame(HS12864TG10B& lcd) : lcd_(lcd) { lcd_.beginFrame(); }
+        ~Frame() { lcd_.endFrame(); }
+        Frame(const Frame&) = delete;
+        Frame& operator=(const Frame&) = delete;
+    private:
+        HS12864TG10B& lcd_;
+    };
     void setInverseDisplay(bool v);
     void drawCircle8Points(uint8_t x0, uint8_t y0, uint8_t x, uint8_t y, uint8_t color) ;
     // 显示8x8 ASCII字符（x：列0-127，y：行0-7，color：0=黑，1=白）
     void showAscii(uint8_t x, uint8_t y, char ch, uint8_t color);
     uint8_t reverseBit(uint8_t data);
     void showAsciiStr(uint8_t x, uint8_t y, const char* str, uint8_t color);
+
+    static const LcdFont FONT_8X8;       // ascii8x8等宽
+    static const LcdFont FONT_8X8_PROP;  // ascii8x8去掉左右空白列的比例版
+    static const LcdCjkFont CJK_16X16;   // 内置16x16汉字库
+
+    // 设置drawString/drawChar使用的字体；cjk为nullptr时不显示非ASCII字符
+    void setFont(const LcdFont& font, const LcdCjkFont* cjk = &CJK_16X16);
+    /**
+     * @brief 在任意像素位置绘制UTF-8字符串（y不必对齐页），整串写入缓冲区后只刷新一次
+     * @details ASCII用当前字体，其余字符查汉字库；'\n'换行回到起始x；超出屏幕部分被裁剪
+     * @return 最后一行结束处的x
+     */
+    int16_t drawString(int16_t x, int16_t y, const char* str, uint8_t color);
+    // 绘制单个字符（code为Unicode码位），返回前进的列数
+    uint8_t drawChar(int16_t x, int16_t y, uint32_t code, uint8_t color);
+    // 字符串按当前字体排版后的宽度（多行取最宽一行）
+    uint16_t textWidth(const char* str) const;
+
+    /**
+     * @brief 硬件滚动：设置显示起始行（指令0x40-0x7F），屏幕顶行显示显存第line行
+     * @details 所有绘制函数的y都是屏幕逻辑行，内部按起始行映射到显存（环形）；
+     *          起始行指令随下一次刷新与数据一起发送
+     */
+    void setStartLine(uint8_t line);
+    // 画面上移rows行，底部新行用fill（0/1）填充；只发送1条指令和新行中变化的列
+    void scroll(uint8_t rows, uint8_t fill = 0);
+
+    // 控制台模式：清屏后从左上角开始输出，写满后每换一行硬件滚动一行（line_height=0用字体高度）
+    void beginConsole(uint8_t line_height = 0);
+    // 追加UTF-8文本，支持'\n'/'\r'，超出行宽自动折行；一次调用只刷新一次
+    void consoleWrite(const char* str, uint8_t color = 1);
+    // 供Logger::setSink()使用：LogF.setSink(HS12864TG10B::consoleSink, &manager.LDC);
+    static void consoleSink(void* lcd, const char* text);
+
+    // 图表模式：推入一个采样（列0-127），画面上移一行，底行画出与上一采样的连线
+    void chartPush(uint8_t value, uint8_t color = 1);
+    void chartReset();            // 下一个采样不与之前的采样相连
     // 画点（x：0-127，y：0-63，color：0=黑，1=白）
     void drawPoint(uint8_t x, uint8_t y, uint8_t color);
     //画垂直直线
@@ -36,28 +102,76 @@ public:
     void drawRect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color, bool fill);
 
     void drawCircle(uint8_t x0, uint8_t y0, uint8_t r, uint8_t color);
+
+    // 水平线（一页内逐列一次按位或/与）
+    void drawHLine(uint8_t x1, uint8_t x2, uint8_t y, uint8_t color);
+    // 垂直线（中间页整字节写入，两端页各一次掩码）
+    void drawVLine(uint8_t x, uint8_t y1, uint8_t y2, uint8_t color);
+    // 实心圆（按列垂直扫描线填充，超出屏幕部分裁剪）
+    void fillCircle(uint8_t x0, uint8_t y0, uint8_t r, uint8_t color);
+    // 实心三角形（按列求上下边界后填充）
+    void fillTriangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t x3, uint8_t y3, uint8_t color);
+    // 粗直线（width：线宽像素）
+    void drawThickLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t width, uint8_t color);
 private:
-    GPIO_TypeDef* scl_port_;  // SPI_SCL引脚（PA5）
-    uint16_t scl_pin_;
-    GPIO_TypeDef* sda_port_;  // SPI_SDA引脚（PA7）
-    uint16_t sda_pin_;
-    GPIO_TypeDef* a0_port_;   // A0引脚（指令/数据，PA2）
-    uint16_t a0_pin_;
-    GPIO_TypeDef* cs_port_;   // CS引脚（片选，PA3）
-    uint16_t cs_pin_;
+    LcdTransport* transport_;  // 指令/数据发送通道
     GPIO_TypeDef* res_port_;  // RES引脚（复位，PA4）
     uint16_t res_pin_;
 
-    void writeBit(uint8_t bit);   // 写1位SPI数据（带时序）
-    void writeCmd(uint8_t cmd);   // 写指令（A0=0）
-    void writeData(uint8_t dat);  // 写数据（A0=1）
+    void writeCmd(uint8_t cmd);   // 写指令（A0=0）并立即发送
+    void present();               // 绘制函数结束时调用：按帧事务/刷新间隔决定是否刷新
     void hardwareReset();         // 硬件复位（符合规格书时序）
-    void setCursor(uint8_t x, uint8_t y);  // 设置光标（x=列，y=页）
+    void setCursor(uint8_t x, uint8_t y);  // 排队设置光标（x=列，y=页），随下次flush发送
+    void setColumn(uint8_t x);    // 排队设置列地址（同页内跳转）
+    void waitBuffer();            // 修改绘制缓冲前等待仍在读取它的传输
+    void setByte(uint8_t page, uint8_t x, uint8_t value);  // 写缓冲区，内容变化时标记脏列
+    void markDirty(uint8_t page, uint8_t x);
+    // 扫描线填充（坐标可越界，内部裁剪；不刷新）
+    void fillArea(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color);
+    void fillRows(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color);
+    void hspan(int16_t x1, int16_t x2, int16_t y, uint8_t color);
+    void vspan(int16_t x, int16_t y1, int16_t y2, uint8_t color);
+    bool isDirty(uint8_t page, uint8_t x) const;
+
+    // 查到的字形：按页平铺的列数据，只绘制[first, first + advance)列，超出字宽的列为空白
+    struct Glyph {
+        const uint8_t* data;  // nullptr=字库中没有，只前进advance
+        uint8_t stride;       // 每页列数
+        uint8_t height;
+        uint8_t first;        // 起始列（比例排版时裁掉的左侧空白）
+        uint8_t advance;      // 绘制并前进的列数（含字间空白）
+        bool reversed;
+    };
+    Glyph findGlyph(uint32_t code, const LcdFont& font) const;
+    // 把字形移位到任意y，每列最多跨3页，逐字节按掩码写入（字形外的位不变）
+    void blitGlyph(int16_t x, int16_t y, const Glyph& glyph, uint8_t color);
+    uint8_t physicalRow(int16_t y) const;  // 逻辑行→显存行（按显示起始行环形偏移）
+    void consoleNewLine();
     uint8_t getPage(uint8_t y);   // 行→页转换（y=0-63 → 页=0-7）
     uint8_t getPageOffset(uint8_t y);  // 行→页内偏移（y=0-63 → 偏移0-7）
 
    uint8_t lcd_buffer[LCD_PAGE][LCD_WIDTH] = {0};  // 现在仅1024字节
+#ifdef _LcdDoubleBuffer
+    uint8_t lcd_back_[LCD_PAGE][LCD_WIDTH] = {0};   // 第二帧缓冲（+1024字节）
+    uint8_t (*draw_)[LCD_WIDTH] = lcd_back_;        // 绘制写入的缓冲
+#else
+    uint8_t (*draw_)[LCD_WIDTH] = lcd_buffer;
+#endif
+    uint8_t (*front_)[LCD_WIDTH] = lcd_buffer;      // 正在/将要发送到屏幕的缓冲
+    uint32_t dirty_cols_[LCD_PAGE][LCD_WIDTH / 32] = {};  // 每页脏列位图（bit=列）
+    uint8_t dirty_pages_ = 0;                        // 含脏列的页位图
+    uint8_t frame_depth_ = 0;                        // beginFrame()嵌套层数
+    uint16_t frame_interval_ = 0;                    // 帧外最小刷新间隔（ms）
+    uint32_t last_flush_ = 0;                        // 上次刷新的tick
+    uint8_t start_line_ = 0;                         // 显示起始行（硬件滚动偏移）
+    bool start_line_pending_ = false;                // 起始行指令待随下次刷新发送
+    int16_t console_x_ = 0;                          // 控制台光标
+    int16_t console_y_ = 0;
+    uint8_t console_line_ = 8;                       // 控制台行高
+    uint8_t chart_last_ = 0xFF;                      // 图表上一个采样（0xFF=无）
+    const LcdFont* font_ = &FONT_8X8;                // 当前字体
+    const LcdCjkFont* cjk_ = &CJK_16X16;             // 当前汉字库
     static const uint8_t ascii8x8[];                // 8x8 ASCII字库
     static const uint8_t chinese16x16[][32];        // 16x16汉字库（每个汉字32字节）
-    static const uint16_t chineseCode[];            // 汉字内码表（与chinese16x16对应）
+    static const uint16_t chineseCode[];            // 汉字Unicode码位表（升序，与chinese16x16对应）
 };
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief LCD串行总线接口：按段发送指令或显示数据，A0只在指令/数据切换时翻转
+ * @details send()只负责排队，flush()启动发送；同步实现在send()中直接发完。
+ *          数据段只保存指针，缓冲区在busy()变为false前不能修改。
+ *          本头文件不依赖HAL，驱动与RecordingTransport可在主机上编译；具体实现见LcdTransport.hpp
+ */
+class LcdTransport {
+public:
+    virtual ~LcdTransport() = default;
+
+    // 配置外设（在GPIO/时钟初始化之后调用）
+    virtual void begin() {}
+
+    /**
+     * @brief 排队一段字节
+     * @param data false=指令（A0=0），true=显示数据（A0=1）
+     */
+    virtual void send(bool data, const uint8_t* buf, uint16_t len) = 0;
+
+    // 开始发送已排队的段；DMA实现在后台完成，CPU立即返回
+    virtual void flush() {}
+
+    // 一次flush()最多可排队的段数，0=不限（同步发送）；驱动据此合并刷新段，避免排队时等待
+    virtual uint8_t capacity() const { return 0; }
+
+    bool busy() const { return busy_; }
+
+    // 等待后台传输结束
+    void wait() const {
+        while (busy_) {}
+    }
+
+protected:
+    volatile bool busy_ = false;
+};
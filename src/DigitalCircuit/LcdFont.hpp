@@ -0,0 +1,46 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * @brief 点阵字体描述（列取模，低位在上，与LCD页字节一致）
+ * @details 每个字形按页平铺：第p页的第c列位于 bitmap[offset + p * width + c]，
+ *          高度不超过16像素（最多2页）。
+ *          等宽字体：offsets/widths为nullptr，字形依次排列，每个占 pages() * width 字节；
+ *          比例字体：widths给出每个字形的列数，offsets给出起始字节
+ */
+struct LcdFont {
+    const uint8_t* bitmap;
+    const uint16_t* offsets;  // 比例字体：各字形在bitmap中的起始下标（可为nullptr）
+    const uint8_t* widths;    // 比例字体：各字形列数（可为nullptr）
+    uint8_t first;            // 首个字符编码（通常0x20）
+    uint8_t last;             // 最后一个字符编码
+    uint8_t width;            // 等宽字体的字宽；比例字体为最大字宽
+    uint8_t height;           // 字高（像素，1~16）
+    uint8_t spacing;          // 比例排版时字间空白列数
+    bool reversed;            // 列倒序存放（最后一个字节是最左列）
+    bool trim;                // 按字形墨迹裁掉左右空白列，把等宽字库当作比例字体使用
+
+    constexpr uint8_t pages() const { return static_cast<uint8_t>((height + 7) / 8); }
+    constexpr bool contains(uint32_t code) const { return code >= first && code <= last; }
+};
+
+/**
+ * @brief 16x16汉字库：codes为升序Unicode码位，glyphs[i]为对应字形（上页16列 + 下页16列）
+ * @details 查找用二分，n个字只需约log2(n)次比较，不额外占用RAM
+ */
+struct LcdCjkFont {
+    const uint16_t* codes;
+    const uint8_t (*glyphs)[32];
+    uint16_t count;
+
+    static constexpr uint8_t SIZE = 16;
+
+    // 码位 → 字形，未收录返回nullptr
+    const uint8_t* find(uint32_t code) const {
+        if (code > 0xFFFF || count == 0) return nullptr;
+        const uint16_t* end = codes + count;
+        const uint16_t* it = std::lower_bound(codes, end, static_cast<uint16_t>(code));
+        return (it != end && *it == code) ? glyphs[it - codes] : nullptr;
+    }
+};
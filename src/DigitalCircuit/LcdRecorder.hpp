@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "LcdBus.hpp"
+
+/**
+ * @brief 记录型传输：不接硬件，按控制器指令集重建屏幕显存，并统计总线流量
+ * @details 解析页地址(0xB0-0xB7)、列地址(0x10-0x1F/0x00-0x0F)、起始行(0x40-0x7F)、
+ *          开关显示(0xAE/0xAF)、反显(0xA6/0xA7)、全亮(0xA4/0xA5)，
+ *          带参数的双字节指令(0x81、0xF8)会跳过参数字节；其余指令只计数。
+ *          可在主机上编译驱动做绘制结果比对（toPbm/checksum），也可在目标板上统计每次操作的字节数
+ * @code
+ * RecordingTransport bus;
+ * HS12864TG10B lcd(bus, GPIOA, GPIO_PIN_4);
+ * bus.resetStats();
+ * lcd.drawRect(10, 10, 50, 30, 1, true);
+ * // bus.stats().data / bus.stats().commands，bus.toPbm(buf, sizeof(buf))
+ */
+class RecordingTransport : public LcdTransport {
+public:
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t HEIGHT = 64;
+    static constexpr size_t PBM_SIZE = 10 + WIDTH / 8 * HEIGHT;  // "P4\n128 64\n"（10字节）+ 像素
+
+    struct Stats {
+        uint32_t commands;  // 指令字节数（含参数）
+        uint32_t data;      // 显示数据字节数
+        uint32_t segments;  // send()调用次数（A0/CS切换次数的上限）
+        uint32_t flushes;   // flush()次数
+        uint32_t overflow;  // 列地址超出屏幕后写入的数据字节（驱动越界的信号）
+    };
+
+    void send(bool data, const uint8_t* buf, uint16_t len) override {
+        stats_.segments++;
+        for (uint16_t i = 0; i < len; i++) {
+            if (data) {
+                writeData(buf[i]);
+            } else {
+                command(buf[i]);
+            }
+        }
+    }
+
+    void flush() override {
+        stats_.flushes++;
+    }
+
+    const Stats& stats() const { return stats_; }
+    void resetStats() { stats_ = {}; }
+
+    // 显存字节（页、列）
+    uint8_t ram(uint8_t page, uint8_t x) const { return ram_[page & 7][x % WIDTH]; }
+    uint8_t startLine() const { return start_line_; }
+    bool displayOn() const { return display_on_; }
+
+    /**
+     * @brief 屏幕上(x, y)处是否点亮：按起始行映射显存行，并计入反显、全亮、关显示
+     */
+    bool pixel(uint8_t x, uint8_t y) const {
+        if (!display_on_) return false;
+        if (all_on_) return true;
+        uint8_t row = (y + start_line_) & (HEIGHT - 1);
+        bool on = (ram_[row >> 3][x % WIDTH] >> (row & 7)) & 1u;
+        return on != inverse_;
+    }
+
+    /**
+     * @brief 以二进制PBM（P4）格式输出当前屏幕，1=点亮
+     * @return 写入的字节数；buf不足PBM_SIZE时返回0
+     */
+    size_t toPbm(uint8_t* buf, size_t size) const {
+        if (buf == nullptr || size < PBM_SIZE) return 0;
+        static const char header[] = "P4\n128 64\n";
+        memcpy(buf, header, sizeof(header) - 1);
+        uint8_t* out = buf + sizeof(header) - 1;
+        for (uint8_t y = 0; y < HEIGHT; y++) {
+            for (uint8_t x = 0; x < WIDTH; x += 8) {
+                uint8_t bits = 0;
+                for (uint8_t b = 0; b < 8; b++) {
+                    bits = static_cast<uint8_t>((bits << 1) | (pixel(x + b, y) ? 1 : 0));  // 高位在左
+                }
+                *out++ = bits;
+            }
+        }
+        return PBM_SIZE;
+    }
+
+    // 屏幕内容的FNV-1a校验值，用于和已知正确的画面比对
+    uint32_t checksum() const {
+        uint32_t hash = 2166136261u;
+        for (uint8_t y = 0; y < HEIGHT; y++) {
+            for (uint8_t x = 0; x < WIDTH; x++) {
+                hash = (hash ^ (pixel(x, y) ? 1u : 0u)) * 16777619u;
+            }
+        }
+        return hash;
+    }
+
+    // 清空显存与指令状态（相当于硬件复位）
+    void reset() {
+        memset(ram_, 0, sizeof(ram_));
+        page_ = 0;
+        column_ = 0;
+        start_line_ = 0;
+        operand_ = false;
+        display_on_ = false;
+        inverse_ = false;
+        all_on_ = false;
+    }
+
+private:
+    uint8_t ram_[HEIGHT / 8][WIDTH] = {};
+    uint8_t page_ = 0;
+    uint8_t column_ = 0;
+    uint8_t start_line_ = 0;
+    bool operand_ = false;  // 下一个指令字节是双字节指令的参数
+    bool display_on_ = false;
+    bool inverse_ = false;
+    bool all_on_ = false;
+    Stats stats_ = {};
+
+    void writeData(uint8_t value) {
+        stats_.data++;
+        if (column_ >= WIDTH) {
+            stats_.overflow++;
+            return;
+        }
+        ram_[page_][column_++] = value;  // 写数据后列地址自动+1
+    }
+
+    void command(uint8_t cmd) {
+        stats_.commands++;
+        if (operand_) {
+            operand_ = false;
+            return;
+        }
+        if ((cmd & 0xF0) == 0xB0) {
+            page_ = cmd & 0x07;
+        } else if ((cmd & 0xF0) == 0x10) {
+            column_ = static_cast<uint8_t>((column_ & 0x0F) | ((cmd & 0x0F) << 4));
+        } else if ((cmd & 0xF0) == 0x00) {
+            column_ = static_cast<uint8_t>((column_ & 0xF0) | (cmd & 0x0F));
+        } else if ((cmd & 0xC0) == 0x40) {
+            start_line_ = cmd & 0x3F;
+        } else if (cmd == 0xAE || cmd == 0xAF) {
+            display_on_ = cmd & 1;
+        } else if (cmd == 0xA6 || cmd == 0xA7) {
+            inverse_ = cmd & 1;
+        } else if (cmd == 0xA4 || cmd == 0xA5) {
+            all_on_ = cmd & 1;
+        } else if (cmd == 0x81 || cmd == 0xF8) {
+            operand_ = true;  // 电量设置/升压倍数：后跟1字节参数
+        }
+    }
+};
@@ -0,0 +1,18 @@
+#include "LcdTransport.hpp"
+
+#ifdef _LcdDma
+// SPI1_TX使用DMA1通道3
+extern "C" void DMA1_Channel3_IRQHandler(void) {
+    if (Spi1DmaTransport::s_active) {
+        HAL_DMA_IRQHandler(Spi1DmaTransport::s_active->dmaHandle());
+    }
+}
+
+// HAL在等待SPI发送结束（BSY清零）后回调，此时可以安全切换A0/CS
+extern "C" void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi) {
+    Spi1DmaTransport* transport = Spi1DmaTransport::s_active;
+    if (transport && hspi == transport->handle()) {
+        transport->onTransferComplete();
+    }
+}
+#endif
@@ -0,0 +1,207 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include "stm32f1xx_hal.h"
+#include "GPIO.hpp"
+#include "Clock.hpp"
+#include "SoftSpi.hpp"
+#include "LcdBus.hpp"
+
+#ifndef LCD_DMA_QUEUE
+#define LCD_DMA_QUEUE 24      // 每次刷新可排队的传输段数
+#endif
+
+#ifndef LCD_DMA_CMD_POOL
+#define LCD_DMA_CMD_POOL 48   // 排队指令字节的暂存区大小
+#endif
+
+// 一次刷新最多：起始行指令1段(1字节) + 8页 ×（页/列地址指令1段(3字节) + 数据1段）
+static_assert(LCD_DMA_QUEUE >= 1 + 8 * 2 && LCD_DMA_QUEUE <= 255, "LCD_DMA_QUEUE不足以容纳一次整屏刷新");
+static_assert(LCD_DMA_CMD_POOL >= 1 + 8 * 3 && LCD_DMA_CMD_POOL <= 255, "LCD_DMA_CMD_POOL不足以容纳一次整屏刷新");
+
+#ifndef LCD_SPI_PRESCALER
+#define LCD_SPI_PRESCALER SPI_BAUDRATEPRESCALER_2  // APB2=8MHz时SCK=4MHz
+#endif
+
+/**
+ * @brief 软件SPI（回退方案，任意引脚可用）
+ * @tparam Bus 位传输引擎（SoftSpi<...>）
+ * @tparam A0Base/A0Pin、CsBase/CsPin 指令/数据选择与片选引脚
+ * @details 每段只拉低一次CS并设置一次A0（同端口时合并为一次BSRR写入），段内字节连续发送
+ */
+template<typename Bus, uintptr_t A0Base, uint16_t A0Pin, uintptr_t CsBase, uint16_t CsPin>
+class BitBangTransport : public LcdTransport {
+public:
+    void send(bool data, const uint8_t* buf, uint16_t len) override {
+        select(data);
+        Bus::write(buf, len);
+        cs()->BSRR = CsPin;  // 禁用CS
+    }
+
+private:
+    static GPIO_TypeDef* cs() { return reinterpret_cast<GPIO_TypeDef*>(CsBase); }
+    static GPIO_TypeDef* a0() { return reinterpret_cast<GPIO_TypeDef*>(A0Base); }
+
+    // CS拉低并设置A0
+    static inline void select(bool data) {
+        uint32_t a0_bits = data ? A0Pin : (static_cast<uint32_t>(A0Pin) << 16);
+        if constexpr (CsBase == A0Base) {
+            cs()->BSRR = a0_bits | (static_cast<uint32_t>(CsPin) << 16);
+        } else {
+            cs()->BSRR = static_cast<uint32_t>(CsPin) << 16;
+            a0()->BSRR = a0_bits;
+        }
+    }
+};
+
+/**
+ * @brief SPI1（PA5=SCK，PA7=MOSI）+ DMA1通道3 后台发送
+ * @details 排队的段按顺序逐段DMA发送，段间在传输完成中断里切换A0；
+ *          整个队列期间CS保持拉低。中断处理在LcdTransport.cpp中，需定义_LcdDma
+ */
+class Spi1DmaTransport : public LcdTransport {
+public:
+    Spi1DmaTransport(GPIO_TypeDef* a0_port, uint16_t a0_pin,
+                     GPIO_TypeDef* cs_port, uint16_t cs_pin)
+        : a0_port_(a0_port), a0_pin_(a0_pin),
+          cs_port_(cs_port), cs_pin_(cs_pin) {}
+
+    void begin() override {
+        ClockManager::Acquire(ClockId::Spi1);
+        ClockManager::Acquire(ClockId::Dma1);
+
+        hdma_.Instance = DMA1_Channel3;  // SPI1_TX
+        hdma_.Init.Direction = DMA_MEMORY_TO_PERIPH;
+        hdma_.Init.PeriphInc = DMA_PINC_DISABLE;
+        hdma_.Init.MemInc = DMA_MINC_ENABLE;
+        hdma_.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdma_.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+        hdma_.Init.Mode = DMA_NORMAL;
+        hdma_.Init.Priority = DMA_PRIORITY_LOW;
+        HAL_DMA_Init(&hdma_);
+
+        hspi_.Instance = SPI1;
+        hspi_.Init.Mode = SPI_MODE_MASTER;
+        hspi_.Init.Direction = SPI_DIRECTION_2LINES;
+        hspi_.Init.DataSize = SPI_DATASIZE_8BIT;
+        hspi_.Init.CLKPolarity = SPI_POLARITY_LOW;   // 空闲SCK低，上升沿采样（与模拟时序一致）
+        hspi_.Init.CLKPhase = SPI_PHASE_1EDGE;
+        hspi_.Init.NSS = SPI_NSS_SOFT;
+        hspi_.Init.BaudRatePrescaler = LCD_SPI_PRESCALER;
+        hspi_.Init.FirstBit = SPI_FIRSTBIT_MSB;
+        hspi_.Init.TIMode = SPI_TIMODE_DISABLE;
+        hspi_.Init.CRCCalculation = SPI_CRCCALCULATION_DISABLE;
+        __HAL_LINKDMA(&hspi_, hdmatx, hdma_);
+        HAL_SPI_Init(&hspi_);
+
+        HAL_NVIC_SetPriority(DMA1_Channel3_IRQn, LCD_DMA_IRQ_PRIORITY, 0);
+        HAL_NVIC_EnableIRQ(DMA1_Channel3_IRQn);
+        s_active = this;
+    }
+
+    void send(bool data, const uint8_t* buf, uint16_t len) override {
+        if (len == 0) return;
+        wait();  // 上一次刷新仍在发送时不能改动队列
+        if (!data) {
+            if (cmd_used_ + len > LCD_DMA_CMD_POOL) drain();
+            // 指令多来自临时变量，复制到暂存区；与上一段指令连续时直接合并
+            uint8_t* dst = cmd_pool_ + cmd_used_;
+            memcpy(dst, buf, len);
+            cmd_used_ += len;
+            if (count_ > 0 && !queue_[count_ - 1].data &&
+                queue_[count_ - 1].buf + queue_[count_ - 1].len == dst) {
+                queue_[count_ - 1].len += len;
+                return;
+            }
+            buf = dst;
+        }
+        if (count_ >= LCD_DMA_QUEUE) {
+            drain();
+            if (!data) {  // 指令已复制到暂存区开头
+                memmove(cmd_pool_, buf, len);
+                buf = cmd_pool_;
+                cmd_used_ = len;
+            }
+        }
+        queue_[count_++] = {buf, len, data};
+    }
+
+    // 驱动按此把每页合并成一段，整次刷新不会触发drain()
+    uint8_t capacity() const override { return LCD_DMA_QUEUE; }
+
+    void flush() override {
+        if (count_ == 0 || busy_) return;
+        busy_ = true;
+        next_ = 0;
+        a0_data_ = !queue_[0].data;  // 保证第一段一定设置A0
+        GPIO::Write(cs_port_, 0, cs_pin_);
+        startNext();
+    }
+
+    /**
+     * @brief 一段DMA传输完成（HAL_SPI_TxCpltCallback中调用，此时SPI已空闲）
+     */
+    void onTransferComplete() {
+        if (next_ < count_) {
+            startNext();
+            return;
+        }
+        finish();
+    }
+
+    // 启动DMA失败的次数（失败时本次队列被丢弃）
+    uint16_t errors() const { return errors_; }
+
+    SPI_HandleTypeDef* handle() { return &hspi_; }
+    DMA_HandleTypeDef* dmaHandle() { return &hdma_; }
+
+    static inline Spi1DmaTransport* s_active = nullptr;  // 中断回调的分发目标
+
+private:
+    struct Segment {
+        const uint8_t* buf;
+        uint16_t len;
+        bool data;
+    };
+
+    GPIO_TypeDef* a0_port_;
+    uint16_t a0_pin_;
+    GPIO_TypeDef* cs_port_;
+    uint16_t cs_pin_;
+    SPI_HandleTypeDef hspi_ = {};
+    DMA_HandleTypeDef hdma_ = {};
+
+    Segment queue_[LCD_DMA_QUEUE];
+    uint8_t cmd_pool_[LCD_DMA_CMD_POOL];
+    volatile uint8_t count_ = 0;
+    volatile uint8_t next_ = 0;
+    uint8_t cmd_used_ = 0;
+    bool a0_data_ = false;
+    uint16_t errors_ = 0;
+
+    void startNext() {
+        const Segment& seg = queue_[next_++];
+        if (seg.data != a0_data_) {  // 只在指令/数据切换时改A0
+            GPIO::Write(a0_port_, seg.data ? a0_pin_ : 0, seg.data ? 0 : a0_pin_);
+            a0_data_ = seg.data;
+        }
+        if (HAL_SPI_Transmit_DMA(&hspi_, const_cast<uint8_t*>(seg.buf), seg.len) != HAL_OK) {
+            ++errors_;
+            finish();  // 不会再有完成中断：清空队列并释放busy_，否则wait()永远不返回
+        }
+    }
+
+    // 队列发送结束（或放弃）：禁用CS，清空队列
+    void finish() {
+        GPIO::Write(cs_port_, cs_pin_, 0);
+        count_ = 0;
+        cmd_used_ = 0;
+        busy_ = false;
+    }
+
+    // 队列已满：先把已排队的段发完
+    void drain() {
+        flush();
+        wait();
+    }
+};
@@ -6,6 +6,13 @@ public:
     LowPowerMode() = default;
     LowPowerMode(const LowPowerMode&) = delete;
     LowPowerMode& operator=(const LowPowerMode&) = delete;
+    /**
+     * @brief 进入SLEEP模式：内核停止，外设与SysTick照常运行，任意中断唤醒后继续执行
+     */
+    void EnterSleepMode() {
+        HAL_PWR_EnterSLEEPMode(PWR_MAINREGULATOR_ON, PWR_SLEEPENTRY_WFI);
+    }
+
     /**
      * @brief 进入STOP低功耗模式
      * @details 配置为低功耗调节器，等待中断唤醒
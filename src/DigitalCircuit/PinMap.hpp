@@ -0,0 +1,206 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <utility>
+#include "GPIO.hpp"
+
+// 端口下标，与port_index()一致
+enum PortId : uint8_t { PORT_A = 0, PORT_B, PORT_C, PORT_D };
+
+/**
+ * @brief 编译期引脚描述（与GPIO_InitTypeDef字段一致，端口用下标表示）
+ */
+struct PinConfig {
+    uint8_t port;       // PORT_A ~ PORT_D
+    uint16_t pin;       // 单个引脚，如GPIO_PIN_7
+    uint32_t mode;      // GPIO_MODE_*（不支持中断/事件模式）
+    uint32_t pull;      // GPIO_NOPULL / GPIO_PULLUP / GPIO_PULLDOWN
+    uint32_t speed;     // GPIO_SPEED_FREQ_*（仅输出/复用输出有效）
+    bool poll = false;  // 登记为轮询引脚（电平变化时产生GpioEvent），仅GPIO_MODE_INPUT有效；
+                        // F1中GPIO_MODE_AF_INPUT与GPIO_MODE_INPUT相同，USART_RX等复用输入应保持false
+};
+
+/**
+ * @brief 单个端口合并后的寄存器值
+ */
+struct PortConfig {
+    uint16_t used = 0;      // 表中出现的引脚
+    uint16_t input = 0;     // poll=true的输入引脚（登记为轮询引脚）
+    uint32_t crl = 0;       // CRL中引脚0~7的MODE/CNF
+    uint32_t crlMask = 0;   // CRL中需改写的位
+    uint32_t crh = 0;       // CRH中引脚8~15的MODE/CNF
+    uint32_t crhMask = 0;
+    uint16_t pullUp = 0;    // 上拉输入：ODR置1
+    uint16_t pullDown = 0;  // 下拉输入：ODR清0
+};
+
+/**
+ * @brief 编译期板级引脚表：合并出每个端口的CRL/CRH/ODR，启动时每个端口只需几次寄存器写入
+ * @tparam Board 提供 static constexpr std::array<PinConfig, N> pins 的类型
+ * @details 引脚重复、引脚号非法、模式不支持都会在编译期报错；
+ *          表内引脚不占用GPIO引脚池，需要中断或附带外设的引脚仍用GPIO::Add()
+ * @code
+ * struct BoardPins {
+ *     static constexpr std::array<PinConfig, 2> pins = {{
+ *         {PORT_A, GPIO_PIN_2, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},
+ *         {PORT_B, GPIO_PIN_1, GPIO_MODE_INPUT, GPIO_PULLUP, GPIO_SPEED_FREQ_LOW, true},  // 按键，轮询
+ *     }};
+ * };
+ * PinMap<BoardPins>::Apply(gpio);
+ * PinMap<BoardPins>::Release(gpio);  // 拆除时
+ */
+template<typename Board>
+class PinMap {
+public:
+    static constexpr uint8_t INVALID_BITS = 0xFF;
+
+    /**
+     * @brief 引脚的4位MODE/CNF值，不支持的配置返回INVALID_BITS
+     */
+    static constexpr uint8_t crBits(const PinConfig& p) {
+        uint32_t speed = p.speed & 0x3;
+        if (p.mode == GPIO_MODE_OUTPUT_PP) return static_cast<uint8_t>((0u << 2) | speed);
+        if (p.mode == GPIO_MODE_OUTPUT_OD) return static_cast<uint8_t>((1u << 2) | speed);
+        if (p.mode == GPIO_MODE_AF_PP)     return static_cast<uint8_t>((2u << 2) | speed);
+        if (p.mode == GPIO_MODE_AF_OD)     return static_cast<uint8_t>((3u << 2) | speed);
+        if (p.mode == GPIO_MODE_ANALOG)    return 0;
+        if (p.mode == GPIO_MODE_INPUT) {   // 含GPIO_MODE_AF_INPUT
+            return p.pull == GPIO_NOPULL ? (1u << 2) : (2u << 2);
+        }
+        return INVALID_BITS;
+    }
+
+    static constexpr bool pinsValid() {
+        for (const PinConfig& p : Board::pins) {
+            if (p.port >= GPIO_PORT_COUNT || p.pin == 0 || (p.pin & (p.pin - 1)) != 0) return false;
+        }
+        return true;
+    }
+
+    static constexpr bool modesValid() {
+        for (const PinConfig& p : Board::pins) {
+            if (crBits(p) == INVALID_BITS) return false;
+        }
+        return true;
+    }
+
+    static constexpr bool pollValid() {
+        for (const PinConfig& p : Board::pins) {
+            if (p.poll && p.mode != GPIO_MODE_INPUT) return false;
+        }
+        return true;
+    }
+
+    static constexpr bool noDuplicates() {
+        std::array<uint16_t, GPIO_PORT_COUNT> seen{};
+        for (const PinConfig& p : Board::pins) {
+            if (seen[p.port] & p.pin) return false;
+            seen[p.port] |= p.pin;
+        }
+        return true;
+    }
+
+    static_assert(pinsValid(), "引脚表：端口越界或pin不是单个GPIO_PIN_x");
+    static_assert(modesValid(), "引脚表：不支持的模式（中断/事件模式请用GPIO::Add）");
+    static_assert(noDuplicates(), "引脚表：同一引脚被重复分配");
+    static_assert(pollValid(), "引脚表：只有输入模式的引脚可以设置poll");
+
+    static constexpr std::array<PortConfig, GPIO_PORT_COUNT> build() {
+        std::array<PortConfig, GPIO_PORT_COUNT> ports{};
+        for (const PinConfig& p : Board::pins) {
+            PortConfig& c = ports[p.port];
+            uint8_t n = static_cast<uint8_t>(__builtin_ctz(p.pin));
+            uint32_t shift = (n & 7u) * 4;
+            uint32_t bits = static_cast<uint32_t>(crBits(p)) << shift;
+            if (n < 8) {
+                c.crl |= bits;
+                c.crlMask |= 0xFu << shift;
+            } else {
+                c.crh |= bits;
+                c.crhMask |= 0xFu << shift;
+            }
+            c.used |= p.pin;
+            bool input = p.mode == GPIO_MODE_INPUT;
+            if (p.poll) c.input |= p.pin;  // 复用输入（AF_INPUT）与普通输入同值，只按poll区分
+            if (input && p.pull == GPIO_PULLUP) c.pullUp |= p.pin;
+            if (input && p.pull == GPIO_PULLDOWN) c.pullDown |= p.pin;
+        }
+        return ports;
+    }
+
+    static constexpr std::array<PortConfig, GPIO_PORT_COUNT> ports = build();
+
+    /**
+     * @brief 打开所需端口时钟、写入合并后的寄存器值，并把引脚登记到gpio（输入引脚参与轮询）
+     * @return 表内引脚已被gpio占用时返回false（该端口不会被改写）
+     */
+    static bool Apply(GPIO& gpio) {
+        return applyPorts(gpio, std::make_index_sequence<GPIO_PORT_COUNT>{});
+    }
+
+    /**
+     * @brief 与Apply()对应：表内引脚恢复为复位状态（浮空输入）、从gpio注销，并释放端口时钟引用
+     * @return 有端口的引脚未由本表登记时返回false（该端口保持不变）
+     */
+    static bool Release(GPIO& gpio) {
+        return releasePorts(gpio, std::make_index_sequence<GPIO_PORT_COUNT>{});
+    }
+
+private:
+    static constexpr uint32_t RESET_CR = 0x44444444u;  // CRL/CRH复位值：全部浮空输入
+
+    template<size_t... I>
+    static bool applyPorts(GPIO& gpio, std::index_sequence<I...>) {
+        return (applyPort<I>(gpio) & ...);
+    }
+
+    template<size_t... I>
+    static bool releasePorts(GPIO& gpio, std::index_sequence<I...>) {
+        return (releasePort<I>(gpio) & ...);
+    }
+
+    template<size_t I>
+    static bool releasePort(GPIO& gpio) {
+        constexpr PortConfig c = ports[I];
+        if constexpr (c.used == 0) {
+            return true;
+        } else {
+            if (!gpio.Unclaim(static_cast<uint8_t>(I), c.used)) return false;
+            GPIO_TypeDef* port = port_from_index(I);
+            if constexpr (c.crlMask != 0) {
+                port->CRL = (port->CRL & ~c.crlMask) | (RESET_CR & c.crlMask);
+            }
+            if constexpr (c.crhMask != 0) {
+                port->CRH = (port->CRH & ~c.crhMask) | (RESET_CR & c.crhMask);
+            }
+            ClockManager::Release(static_cast<ClockId>(I));
+            return true;
+        }
+    }
+
+    template<size_t I>
+    static bool applyPort(GPIO& gpio) {
+        constexpr PortConfig c = ports[I];
+        if constexpr (c.used == 0) {
+            return true;
+        } else {
+            if (gpio.GetUsedMask(port_from_index(I)) & c.used) return false;
+            ClockManager::Acquire(static_cast<ClockId>(I));
+            GPIO_TypeDef* port = port_from_index(I);
+            if constexpr ((c.pullUp | c.pullDown) != 0) {
+                GPIO::Write(port, c.pullUp, c.pullDown);  // 先定上下拉方向，再切换模式
+            }
+            if constexpr (c.crlMask == 0xFFFFFFFFu) {
+                port->CRL = c.crl;
+            } else if constexpr (c.crlMask != 0) {
+                port->CRL = (port->CRL & ~c.crlMask) | c.crl;
+            }
+            if constexpr (c.crhMask == 0xFFFFFFFFu) {
+                port->CRH = c.crh;
+            } else if constexpr (c.crhMask != 0) {
+                port->CRH = (port->CRH & ~c.crhMask) | c.crh;
+            }
+            return gpio.Claim(static_cast<uint8_t>(I), c.used, c.input);
+        }
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <utility>
+#include "stm32f1xx_hal.h"
+
+#ifndef SOFT_SPI_CORE_HZ
+#define SOFT_SPI_CORE_HZ 8000000UL  // 内核时钟（SystemClock_Config：HSI 8MHz，无PLL）
+#endif
+
+/**
+ * @brief 寄存器级软件SPI（模式0：SCK空闲低，上升沿采样，高位先传）
+ * @tparam SclBase/SclPin  SCK所在端口基地址（如GPIOA_BASE）与引脚位
+ * @tparam SdaBase/SdaPin  MOSI所在端口基地址与引脚位
+ * @tparam MinPulseNs 器件要求的SCK高/低电平最小宽度（ns），编译期换算成等待周期
+ * @tparam CoreHz 内核时钟
+ * @details 每位只写BSRR：同端口时“数据+SCK拉低”一次写入、“SCK拉高”一次写入；
+ *          每字节8位完全展开，不调用HAL、不用微秒延时。可复用于其他软件SPI器件
+ * @code using LcdBus = SoftSpi<GPIOA_BASE, GPIO_PIN_5, GPIOA_BASE, GPIO_PIN_7, 50>; LcdBus::write(buf, len);
+ */
+template<uintptr_t SclBase, uint16_t SclPin, uintptr_t SdaBase, uint16_t SdaPin,
+         uint32_t MinPulseNs = 50, uint32_t CoreHz = SOFT_SPI_CORE_HZ>
+class SoftSpi {
+public:
+    // 每个半周期需要的内核周期数（向上取整），扣除一次BSRR写入本身
+    static constexpr uint32_t HALF_CYCLES = (MinPulseNs * (CoreHz / 1000000UL) + 999) / 1000;
+    static constexpr uint32_t DELAY_CYCLES = HALF_CYCLES > 1 ? HALF_CYCLES - 1 : 0;
+
+    static inline void writeByte(uint8_t byte) {
+        writeBits(byte, std::make_integer_sequence<int, 8>{});
+    }
+
+    static void write(const uint8_t* buf, uint16_t len) {
+        for (uint16_t n = 0; n < len; n++) {
+            writeByte(buf[n]);
+        }
+        scl()->BSRR = static_cast<uint32_t>(SclPin) << 16;  // 结束后SCK回到空闲低
+    }
+
+private:
+    static GPIO_TypeDef* scl() { return reinterpret_cast<GPIO_TypeDef*>(SclBase); }
+    static GPIO_TypeDef* sda() { return reinterpret_cast<GPIO_TypeDef*>(SdaBase); }
+
+    template<int... I>
+    static inline void writeBits(uint8_t byte, std::integer_sequence<int, I...>) {
+        (writeBit<7 - I>(byte), ...);  // 高位先传
+    }
+
+    template<int N>
+    static inline void writeBit(uint8_t byte) {
+        uint32_t data = ((byte >> N) & 1u) ? SdaPin : (static_cast<uint32_t>(SdaPin) << 16);
+        if constexpr (SclBase == SdaBase) {
+            sda()->BSRR = data | (static_cast<uint32_t>(SclPin) << 16);  // 数据+SCK拉低
+        } else {
+            scl()->BSRR = static_cast<uint32_t>(SclPin) << 16;
+            sda()->BSRR = data;
+        }
+        delayCycles<DELAY_CYCLES>();
+        scl()->BSRR = SclPin;  // 上升沿，器件采样
+        delayCycles<DELAY_CYCLES>();
+    }
+
+    template<uint32_t N>
+    static inline void delayCycles() {
+        if constexpr (N == 0) {
+        } else if constexpr (N <= 8) {
+            __NOP();
+            delayCycles<N - 1>();
+        } else {
+            for (volatile uint32_t i = N / 4; i; --i) {}  // 每圈约4周期
+        }
+    }
+};
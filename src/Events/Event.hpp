@@ -1,13 +1,100 @@
 #pragma once
 #include "../include/Events.hpp"
 #include "stm32f1xx_hal.h"
-#include "DigitalCircuit/GPIO.hpp"
+#include "DigitalCircuit/GpioPort.hpp"
 
+class GpioData;  // 定义见GPIO.hpp；事件只持有指针，主机端回放时为nullptr
+
+enum class GpioEdge : uint8_t {
+    RISING,     // 低→高
+    FALLING     // 高→低
+};
+
+/**
+ * @brief GPIO电平跳变事件（仅在边沿触发）
+ * @details 订阅GpioEvent接收双边沿，订阅GpioRisingEvent/GpioFallingEvent只接收单边沿。
+ *          轮询引脚按debounce_ms消抖后才触发；EXTI引脚是中断捕获的原始边沿，不消抖（抖动会产生多次事件），
+ *          需要消抖的按键请配置为轮询输入
+ */
 struct GpioEvent:EmbeddedEvent::Event{
     uint16_t pin;
+    GpioEdge edge;
     GPIO_TypeDef* Port;
     GPIO_PinState state;    
     GpioData* Data;
+    uint32_t timestamp = 0;     // 边沿时间（us，约71.6分钟回绕，见tick_to_us）；中断模式由EXTI捕获，轮询模式为消抖确认时的tick
     GpioEvent(uint16_t p, GPIO_TypeDef* pt, GPIO_PinState s,GpioData* data)
-        : pin(p), Port(pt),state(s), Data(data){}
+        : pin(p), edge(s == GPIO_PIN_SET ? GpioEdge::RISING : GpioEdge::FALLING),
+          Port(pt),state(s), Data(data){}
+
+    // 记录/回放负载（回放时Data为nullptr）；timestamp保留边沿时刻，回放可复现现场的边沿间隔
+    static constexpr uint8_t RECORD_ID = 1;
+    struct Payload {
+        uint32_t timestamp; // 边沿时间（us）
+        uint8_t port;       // 端口下标
+        uint8_t pin_index;  // 引脚号0~15
+        uint8_t state;
+        uint8_t reserved;   // 填充字节显式置0，保证记录内容确定
+    };
+    explicit GpioEvent(const Payload& p)
+        : GpioEvent(static_cast<uint16_t>(1u << p.pin_index), port_from_index(p.port),
+                    static_cast<GPIO_PinState>(p.state), nullptr){
+        timestamp = p.timestamp;
+    }
+    Payload payload() const {
+        return {timestamp, port_index(Port), static_cast<uint8_t>(pin ? __builtin_ctz(pin) : 0),
+                static_cast<uint8_t>(state), 0};
+    }
+
+    // 主题 = 端口下标*16 + 引脚号，用于按端口/引脚过滤监听器
+    static constexpr uint16_t TOPIC_COUNT = GPIO_PORT_COUNT * 16;
+    uint16_t topic() const {
+        if (pin == 0) return TOPIC_COUNT;
+        return port_index(Port) * 16 + __builtin_ctz(pin);
+    }
+
+    /**
+     * @brief 生成端口/引脚过滤条件，注册监听器时使用
+     * @param pinMask 引脚位掩码（如GPIO_PIN_0 | GPIO_PIN_3），默认整个端口
+     * @code mDispatcher.registerListener<GpioEvent>(cb, EventPriority::NORMAL, GpioEvent::topics(GPIOA, GPIO_PIN_0));
+     */
+    static EmbeddedEvent::TopicSet topics(GPIO_TypeDef* port, uint16_t pinMask = GPIO_PIN_All) {
+        uint8_t index = port_index(port);
+        if (index >= GPIO_PORT_COUNT) return 0;
+        return static_cast<EmbeddedEvent::TopicSet>(pinMask) << (index * 16);
+    }
+};
+
+struct GpioRisingEvent:GpioEvent{
+    using GpioEvent::GpioEvent;
+    static constexpr uint8_t RECORD_ID = 2;
+};
+
+struct GpioFallingEvent:GpioEvent{
+    using GpioEvent::GpioEvent;
+    static constexpr uint8_t RECORD_ID = 3;
+};
+
+/**
+ * @brief 一个边沿的完整通知：依次触发GpioEvent与对应的GpioRisingEvent/GpioFallingEvent
+ * @details 轮询直接dispatch()；EXTI中断只post()这一条（占一个队列槽位），出队时再展开，
+ *          订阅方要么收到一对事件，要么（队列满时）整对丢弃，不会只收到其中一个
+ */
+struct GpioEdgeEvent:GpioEvent{
+    using GpioEvent::GpioEvent;
+
+    template<typename Router>
+    void dispatch(Router& router) const {
+        GpioEvent event = *this;  // 监听器可修改事件，各自使用副本
+        router.trigger(event);
+        if (state == GPIO_PIN_SET) {
+            GpioRisingEvent rising(pin, Port, state, Data);
+            rising.timestamp = timestamp;
+            router.trigger(rising);
+        } else {
+            GpioFallingEvent falling(pin, Port, state, Data);
+            falling.timestamp = timestamp;
+            router.trigger(falling);
+        }
+    }
 };
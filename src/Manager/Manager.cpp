@@ -6,49 +6,91 @@ Manager::Manager(/* args */){
 }
 
 Manager::~Manager(){
-    if(gpio.clock[0].first){
-        __HAL_RCC_GPIOA_CLK_DISABLE();
+    gpio.DeInitAll();  // 释放引脚占用的时钟，无人使用的外设时钟随之关闭
+    PinMap<BoardPins>::Release(gpio);  // 板级引脚表持有的端口时钟引用
+}
+void Manager::read() {
+    for (uint8_t index = 0; index < GPIO_PORT_COUNT; ++index) {
+        readPort(index);
     }
-     if(gpio.clock[1].first){
-        __HAL_RCC_GPIOB_CLK_DISABLE();
+    dispatchQueued();
+}
+
+void Manager::read(GPIO_TypeDef* port) {
+    readPort(port_index(port));
+}
+
+/**
+ * @brief 整端口采样一次，只处理电平变化或等待消抖的引脚，消抖后在边沿触发事件
+ */
+void Manager::readPort(uint8_t index) {
+    uint16_t changed = gpio.SampleChanges(index);
+    for (uint16_t pin : PinBits(changed)) {
+        GpioData* data = gpio.GetDataAt(index, pin);
+        if (data) data->change_tick = tick;
     }
-     if(gpio.clock[2].first){
-        __HAL_RCC_GPIOC_CLK_DISABLE();
+
+    uint16_t pending = gpio.GetPending(index);
+    if (pending == 0) return;
+    uint16_t level = gpio.GetSnapshot(index);
+    GPIO_TypeDef* port = port_from_index(index);
+    for (uint16_t pin : PinBits(pending)) {
+        GpioData* data = gpio.GetDataAt(index, pin);
+        if (data && tick - data->change_tick < data->debounce_ms) continue;  // 无池数据的引脚不消抖
+        gpio.CommitStable(index, pin);
+
+        GPIO_PinState state = (level & pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+        GpioEdgeEvent edge(pin, port, state, data);
+        edge.timestamp = tick_to_us(tick);
+        edge.dispatch(mDispatcher);  // 与EXTI引脚出队时相同的GpioEvent + 单边沿事件
     }
 }
-void Manager::read() {
-    gpio.ForEach([this](GPIO_TypeDef* port, uint16_t pin, GpioData* data) {
-        if(data->Gpio_initialized){
-            GPIO_PinState state = gpio.read(port, pin);
-            GpioEvent event(pin, port, state, data);
-            mDispatcher.trigger(event);
-        }
-    });
+
+/**
+ * @brief EXTI边沿回调（中断上下文）：只把事件投递进队列，由主循环dispatchQueued()分发
+ * @details 每个边沿只占一个队列槽位，出队时展开为GpioEvent + 单边沿事件；队列满时整个边沿丢弃并计数
+ */
+static void onExtiEdge(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state, uint32_t timestamp) {
+    GpioEdgeEvent edge(pin, port, state, manager.gpio.GetData(port, pin));
+    edge.timestamp = timestamp;
+    manager.mDispatcher.post(edge);
 }
 
-void Manager::read(GPIO_TypeDef port) {
-     gpio.ForEach([this](GPIO_TypeDef* port, uint16_t pin, GpioData* data) {
-        if(data->Gpio_initialized&&data->port==port){
-            GPIO_PinState state = gpio.read(port, pin);
-            GpioEvent event(pin, port, state, data);
-            mDispatcher.trigger(event);
+/**
+ * @brief 在时间预算内分发中断投递的事件
+ */
+void Manager::dispatchQueued() {
+    uint32_t start = HAL_GetTick();
+    while (mDispatcher.dispatchQueued()) {
+        if (eventBudget != 0 && HAL_GetTick() - start >= eventBudget) {
+            break;
         }
-    });
+    }
 }
 
-void Manager::init() {
-    gpio.Add(GPIOA,{GPIO_PIN_7,GPIO_MODE_OUTPUT_PP,GPIO_NOPULL,GPIO_SPEED_FREQ_HIGH});  //SDA
-    gpio.Add(GPIOA,{GPIO_PIN_5,GPIO_MODE_OUTPUT_PP,GPIO_NOPULL,GPIO_SPEED_FREQ_HIGH});  //SCL
-    gpio.Add(GPIOA,{GPIO_PIN_4,GPIO_MODE_OUTPUT_PP,GPIO_NOPULL,GPIO_SPEED_FREQ_HIGH});  //CS
-    gpio.Add(GPIOA,{GPIO_PIN_3,GPIO_MODE_OUTPUT_PP,GPIO_NOPULL,GPIO_SPEED_FREQ_HIGH});  //RES
-    gpio.Add(GPIOA,{GPIO_PIN_2,GPIO_MODE_OUTPUT_PP,GPIO_NOPULL,GPIO_SPEED_FREQ_HIGH});  //A0
-    gpio.Add(GPIOB, {GPIO_PIN_0, GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH});    //背光A
-
-    gpio.Add(GPIOA, {GPIO_PIN_9, GPIO_MODE_AF_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH});   // USART1_TX
-    gpio.Add(GPIOA, {GPIO_PIN_10, GPIO_MODE_AF_INPUT, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH});    // USART1_RX
+/**
+ * @brief 自上次调用以来因队列满而丢弃的中断事件数（供主循环写日志）
+ */
+uint16_t Manager::takeDroppedEvents() {
+    uint16_t dropped = mDispatcher.queue().dropped();
+    uint16_t count = dropped - reportedDrops;
+    reportedDrops = dropped;
+    return count;
+}
 
+/**
+ * @return 有引脚初始化失败（板级引脚表与已占用引脚冲突、EXTI线冲突）时返回false，其余外设仍照常初始化
+ */
+bool Manager::init() {
+    bool ok = PinMap<BoardPins>::Apply(gpio);  // 板级引脚：编译期生成的寄存器值直接写入
+    // 需要中断、消抖或附带外设的引脚在此gpio.Add()，由InitAll()初始化
 
-    gpio.InitAll();
+    GPIO::SetExtiCallback(onExtiEdge);
+    ok = gpio.InitAll() && ok;
+#ifdef _EventRecord
+    mDispatcher.attachRecorder(&recorder);
+#endif
     initManager=true;
+    return ok;
 }
 Manager manager = Manager();
@@ -1,16 +1,52 @@
 #pragma once
 #include "../Events/Event.hpp"
 #include "DigitalCircuit/GPIO.hpp"
+#include "DigitalCircuit/PinMap.hpp"
+#include "../DigitalCircuit/LcdTransport.hpp"
 #include "../DigitalCircuit/HS12864TG10B.hpp"
+// 事件路由类型：默认运行时Dispatcher；处理函数在编译期固定时可换成
+// EmbeddedEvent::StaticRouter<Handler<...>, ...>。trigger/post/dispatchQueued/attachRecorder照常可用，
+// 但StaticRouter没有运行时registerListener/unregisterListener/clear*Listeners（调用处static_assert报错），
+// 原先运行时注册的监听器需改写为Handler/MemberHandler模板参数
+using EventRouter = EmbeddedEvent::Dispatcher;
+
+#ifdef _LcdDma
+#define LCD_BUS_MODE GPIO_MODE_AF_PP      // PA5/PA7交给SPI1
+#else
+#define LCD_BUS_MODE GPIO_MODE_OUTPUT_PP  // PA5/PA7由软件模拟SPI
+#endif
+
+// LCD软件SPI：SCL=PA5，SDA=PA7，SCK高/低电平最小宽度50ns
+using LcdSoftSpi = SoftSpi<GPIOA_BASE, GPIO_PIN_5, GPIOA_BASE, GPIO_PIN_7, 50>;
+
+// 板级引脚表：编译期合并成各端口的CRL/CRH，init()中一次写入
+struct BoardPins {
+    static constexpr std::array<PinConfig, 8> pins = {{
+        {PORT_A, GPIO_PIN_7,  LCD_BUS_MODE,        GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // SDA
+        {PORT_A, GPIO_PIN_5,  LCD_BUS_MODE,        GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // SCL
+        {PORT_A, GPIO_PIN_4,  GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // RES
+        {PORT_A, GPIO_PIN_3,  GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // CS
+        {PORT_A, GPIO_PIN_2,  GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // A0
+        {PORT_B, GPIO_PIN_0,  GPIO_MODE_OUTPUT_PP, GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // 背光A
+        {PORT_A, GPIO_PIN_9,  GPIO_MODE_AF_PP,     GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // USART1_TX
+        {PORT_A, GPIO_PIN_10, GPIO_MODE_AF_INPUT,  GPIO_NOPULL, GPIO_SPEED_FREQ_HIGH},  // USART1_RX
+    }};
+};
+
 class Manager{
 public:
-    HS12864TG10B LDC=HS12864TG10B(
-        GPIOA, GPIO_PIN_5,  // SCL
-        GPIOA, GPIO_PIN_7,  // SDA
+#ifdef _LcdDma
+    Spi1DmaTransport lcdBus=Spi1DmaTransport(
         GPIOA, GPIO_PIN_2,  // A0
-        GPIOA, GPIO_PIN_3,  // CS
-        GPIOA, GPIO_PIN_4   // RES
+        GPIOA, GPIO_PIN_3   // CS
     );
+#else
+    BitBangTransport<LcdSoftSpi,
+        GPIOA_BASE, GPIO_PIN_2,  // A0
+        GPIOA_BASE, GPIO_PIN_3   // CS
+    > lcdBus;
+#endif
+    HS12864TG10B LDC=HS12864TG10B(lcdBus, GPIOA, GPIO_PIN_4);  // RES
 
     Manager(/* args */);
     ~Manager();
@@ -20,12 +56,22 @@ public:
     bool initManager=false;
     GPIO gpio;
     uint32_t tick=0;
+    uint32_t eventBudget=1;     // 每轮处理排队事件的时间预算（ms），0表示全部处理
    // UART_HandleTypeDef huart1;
-    EmbeddedEvent::Dispatcher mDispatcher;
+    EventRouter mDispatcher;
+#ifdef _EventRecord
+    // 事件记录器，经串口导出：recorder.dump([](const uint8_t* d, size_t n){ HAL_UART_Transmit(&Data.huart1, d, n, 100); });
+    EmbeddedEvent::EventRecorder recorder=EmbeddedEvent::EventRecorder(HAL_GetTick);
+#endif
 
-    void init();
+    bool init();
     void read();
-    void read(GPIO_TypeDef port); 
+    void read(GPIO_TypeDef* port); 
+    void dispatchQueued();
+    uint16_t takeDroppedEvents();
+private:
+    uint16_t reportedDrops=0;  // 已报告的队列丢弃计数
+    void readPort(uint8_t index);
     
 
 
@@ -17,6 +17,13 @@ public:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    // 额外的输出目标（如LCD控制台），每条日志以"[LEVEL] message\n"回调一次
+    using Sink = void (*)(void* context, const char* text);
+    void setSink(Sink sink, void* context) {
+        sink_ = sink;
+        sink_context_ = context;
+    }
+
     void Log( LogLevel level ,std::string message) {
 #ifndef _Log
     return;
@@ -31,6 +38,9 @@ public:
          HAL_UART_Transmit(huart_, (const uint8_t*)level_str.c_str(), level_str.length(), 100);
          HAL_UART_Transmit(huart_, (const uint8_t*)message.c_str(), message.length(), 100);
          HAL_UART_Transmit(huart_, (const uint8_t*)"\r\n", 2, 100);
+         if (sink_) {
+             sink_(sink_context_, (level_str + message + "\n").c_str());
+         }
     }
 
     void logF(LogLevel level ,std::string message, ...) {
@@ -49,5 +59,7 @@ public:
     
 private:
      UART_HandleTypeDef* huart_;
+     Sink sink_ = nullptr;
+     void* sink_context_ = nullptr;
 
 };
\ No newline at end of file
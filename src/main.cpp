@@ -1,6 +1,7 @@
 #include "Manager/Manager.hpp"
 #include "Utils/Utils.hpp"
 #include "Data/Data.hpp"
+#include "DigitalCircuit/LowPowerMode.hpp"
 
 int main(void) {
     HAL_Init();
@@ -11,28 +12,42 @@ int main(void) {
 #ifdef _Log
     USART1_UART_Init();  //logger USART1初始化
 #endif
-    manager.init();
+    if (!manager.init()) {
+        LogF.logF(LogLevel::ERROR,"GPIO init failed (pin map or EXTI line conflict)");
+    }
     
     LogF.logF(LogLevel::INFO,"Initialized");
     HAL_GPIO_WritePin(GPIOB,GPIO_PIN_0,GPIO_PIN_SET);
     manager.LDC.init();
+    manager.LDC.beginFrame();                         // 三个图形合并为一次刷新
     manager.LDC.drawRect(10, 10, 50, 30, 1, true);    // 小填充矩形（左上角）
     manager.LDC.drawRect(77, 10, 117, 30, 1, false);  // 小描边矩形（右上角）
     manager.LDC.drawCircle(64, 48, 12, 1);           // 小圆形（下方居中）
+    manager.LDC.endFrame();
     
     LogF.logF(LogLevel::INFO,"Gpio Size:%d GPIOA:%d GPIOB:%d GPIOC:%d"
         ,manager.gpio.GetGpioSize()
-        ,manager.gpio.clock[0].second
-        ,manager.gpio.clock[1].second
-        ,manager.gpio.clock[2].second
+        ,ClockManager::RefCount(ClockId::GpioA)
+        ,ClockManager::RefCount(ClockId::GpioB)
+        ,ClockManager::RefCount(ClockId::GpioC)
     );
 
 
+    LowPowerMode power;
     while (true) {
         manager.read();      
+        manager.LDC.update();  // 发送按刷新间隔延迟的绘制
+        if (uint16_t dropped = manager.takeDroppedEvents()) {
+            LogF.logF(LogLevel::WARN,"Event queue full, %d GPIO edges dropped", dropped);
+        }
 #ifdef _Dog
         HAL_IWDG_Refresh(&Data.hiwdg);  // 喂狗
 #endif
+        // 排队事件已分发完时睡到下一个中断（SysTick每1ms、EXTI边沿、LCD DMA完成都会唤醒）；
+        // 判断后、睡眠前到达的边沿最迟在下一个SysTick被处理
+        if (manager.mDispatcher.queue().empty()) {
+            power.EnterSleepMode();
+        }
      //  LogF.logF(LogLevel::INFO,"Tick");
     }
 }
@@ -42,8 +57,3 @@ extern "C" void SysTick_Handler(void){   //每1msTick运行一次
     manager.tick=HAL_GetTick();
   }
 }
-
-/* extern "C" void EXTI0_IRQHandler(void){
-  
-}
- */
\ No newline at end of file
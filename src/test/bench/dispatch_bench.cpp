@@ -0,0 +1,54 @@
+// 主机端基准：Dispatcher::trigger()耗时与MAX_EVENT_TYPES无关
+// 由run_bench.sh以不同的-DMAX_EVENT_TYPES分别编译，交替运行多次取中位数
+#include <chrono>
+#include <cstdio>
+#include <utility>
+#include "Events.hpp"
+
+using namespace EmbeddedEvent;
+
+template<int N>
+struct BenchEvent : Event {
+    uint32_t value = 0;
+};
+
+static volatile uint32_t g_sink = 0;
+
+template<int N>
+static void onEvent(BenchEvent<N>& event) {
+    g_sink = g_sink + event.value;
+}
+
+// 每个事件类型注册一个监听器，填满整个监听器表
+template<int... I>
+static void registerAll(Dispatcher& dispatcher, std::integer_sequence<int, I...>) {
+    (dispatcher.registerListener<BenchEvent<I>>(&onEvent<I>), ...);
+}
+
+template<int N>
+static double measure(Dispatcher& dispatcher, uint32_t rounds) {
+    BenchEvent<N> event;
+    double best = 1e30;
+    for (int run = 0; run < 7; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds; ++i) {
+            event.value = i;
+            dispatcher.trigger(event);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / rounds;
+        if (ns < best) best = ns;
+    }
+    return best;
+}
+
+int main() {
+    static Dispatcher dispatcher;
+    registerAll(dispatcher, std::make_integer_sequence<int, MAX_EVENT_TYPES>{});
+    constexpr uint32_t rounds = 2000000;
+    // 第一个与最后一个注册的类型：线性查找时两者耗时相差MAX_EVENT_TYPES倍
+    double first = measure<0>(dispatcher, rounds);
+    double last = measure<MAX_EVENT_TYPES - 1>(dispatcher, rounds);
+    printf("MAX_EVENT_TYPES=%d first=%.2fns last=%.2fns\n", MAX_EVENT_TYPES, first, last);
+    return g_sink == 0xFFFFFFFFu;
+}
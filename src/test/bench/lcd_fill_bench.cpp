@@ -0,0 +1,162 @@
+// 主机端基准：HS12864TG10B按页span填充与原始实现（lcd_buffer + 逐点drawPoint）对比
+// 参照实现照抄自仓库初始版本，不含脏列标记；先比对两者得到的显存是否逐字节一致，再计时
+// 只计绘制到缓冲区的耗时（新实现在帧事务内，不发送数据），原实现每次绘制后的整屏刷新不计入
+// 填充类用例加速比低于FILL_MIN_SPEEDUP视为失败
+// 由run_bench.sh以-DUNIT_TEST和src/test/native下的HAL替身编译
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "DigitalCircuit/HS12864TG10B.hpp"
+#include "DigitalCircuit/LcdRecorder.hpp"
+
+#ifndef FILL_MIN_SPEEDUP
+#define FILL_MIN_SPEEDUP 20.0
+#endif
+
+struct NullTransport : LcdTransport {
+    void send(bool, const uint8_t*, uint16_t) override {}
+};
+
+// 初始版本的显存与画点/画矩形/画线（drawPoint原在独立的.cpp中，跨编译单元调用，不会被内联）
+struct BaselineLcd {
+    uint8_t lcd_buffer[8][LCD_WIDTH];
+
+    static uint8_t getPage(uint8_t y) { return y / 8; }
+    static uint8_t getPageOffset(uint8_t y) { return y % 8; }
+
+    __attribute__((noinline)) void drawPoint(uint8_t x, uint8_t y, uint8_t color) {
+        if (x >= LCD_WIDTH || y >= LCD_HEIGHT) return;
+        uint8_t page = getPage(y);
+        uint8_t offset = getPageOffset(y);
+        if (color == 1) {
+            lcd_buffer[page][x] |= (1 << offset);
+        } else {
+            lcd_buffer[page][x] &= ~(1 << offset);
+        }
+    }
+
+    void drawRect(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color, bool fill) {
+        if (x2 > 127) x2 = 127;
+        if (y2 > 63) y2 = 63;
+        if (fill) {
+            for (uint8_t y = y1; y <= y2; y++) {
+                for (uint8_t x = x1; x <= x2; x++) {
+                    drawPoint(x, y, color);
+                }
+            }
+            return;
+        }
+        for (uint8_t x = x1; x <= x2; x++) drawPoint(x, y1, color);
+        for (uint8_t x = x1; x <= x2; x++) drawPoint(x, y2, color);
+        for (uint8_t y = y1 + 1; y < y2; y++) drawPoint(x1, y, color);
+        for (uint8_t y = y1 + 1; y < y2; y++) drawPoint(x2, y, color);
+    }
+
+    // 初始版本的Bresenham drawLine在水平/垂直线上退化为逐点步进
+    void drawLine(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, uint8_t color) {
+        int16_t dx = x2 - x1;
+        int16_t dy = y2 - y1;
+        int16_t sx = (dx > 0) ? 1 : (dx < 0) ? -1 : 0;
+        int16_t sy = (dy > 0) ? 1 : (dy < 0) ? -1 : 0;
+        dx = (dx < 0) ? -dx : dx;
+        dy = (dy < 0) ? -dy : dy;
+        int16_t err = dx - dy;
+        int16_t x = x1, y = y1;
+        while (1) {
+            drawPoint(x, y, color);
+            if (x == x2 && y == y2) break;
+            int16_t err2 = 2 * err;
+            if (err2 > -dy) { err -= dy; x += sx; }
+            if (err2 < dx) { err += dx; y += sy; }
+        }
+    }
+};
+
+struct Case {
+    const char* name;
+    bool fill;  // 计入FILL_MIN_SPEEDUP判定
+    void (*span)(HS12864TG10B&, uint8_t);
+    void (*ref)(BaselineLcd&, uint8_t);
+};
+
+static const Case CASES[] = {
+    {"full-screen fill", true,
+     [](HS12864TG10B& lcd, uint8_t c) { lcd.drawRect(0, 0, 127, 63, c, true); },
+     [](BaselineLcd& lcd, uint8_t c) { lcd.drawRect(0, 0, 127, 63, c, true); }},
+    {"two nested fills", true,
+     [](HS12864TG10B& lcd, uint8_t c) { lcd.drawRect(3, 5, 120, 58, c, true); lcd.drawRect(20, 13, 90, 42, !c, true); },
+     [](BaselineLcd& lcd, uint8_t c) { lcd.drawRect(3, 5, 120, 58, c, true); lcd.drawRect(20, 13, 90, 42, !c, true); }},
+    {"rect outline", false,
+     [](HS12864TG10B& lcd, uint8_t c) { lcd.drawRect(7, 3, 119, 61, c, false); },
+     [](BaselineLcd& lcd, uint8_t c) { lcd.drawRect(7, 3, 119, 61, c, false); }},
+    {"h+v lines", false,
+     [](HS12864TG10B& lcd, uint8_t c) { lcd.drawLine(5, 33, 120, 33, c); lcd.drawLine(77, 3, 77, 60, c); },
+     [](BaselineLcd& lcd, uint8_t c) { lcd.drawLine(5, 33, 120, 33, c); lcd.drawLine(77, 3, 77, 60, c); }},
+};
+
+static GPIO_TypeDef g_res;
+
+// 两种实现各画三次（中间一次擦除），新实现刷新到RecordingTransport后与原实现的lcd_buffer逐字节比较
+static bool sameOutput(const Case& test) {
+    RecordingTransport bus;
+    HS12864TG10B lcd(bus, &g_res, GPIO_PIN_4);
+    lcd.init();
+    static BaselineLcd ref;
+    memset(ref.lcd_buffer, 0, sizeof(ref.lcd_buffer));
+    for (uint8_t color : {1, 0, 1}) {
+        { HS12864TG10B::Frame frame(lcd); test.span(lcd, color); }
+        test.ref(ref, color);
+    }
+    for (uint8_t page = 0; page < 8; page++) {
+        for (uint8_t x = 0; x < LCD_WIDTH; x++) {
+            if (bus.ram(page, x) != ref.lcd_buffer[page][x]) return false;
+        }
+    }
+    return bus.stats().overflow == 0;
+}
+
+// 重复绘制rounds次（颜色交替，每次都真正改动缓冲区）的平均耗时
+template<typename Draw>
+static double timeRounds(uint32_t rounds, Draw draw) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < rounds; ++i) {
+        draw(i & 1);
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count() / rounds;
+}
+
+// 两种实现交替各跑15次（抵消主机频率漂移），各取最快的一次
+static void measure(const Case& test, uint32_t rounds, double& ref_us, double& span_us) {
+    NullTransport bus;
+    HS12864TG10B lcd(bus, &g_res, GPIO_PIN_4);
+    lcd.init();
+    static BaselineLcd ref;
+    memset(ref.lcd_buffer, 0, sizeof(ref.lcd_buffer));
+    ref_us = span_us = 1e30;
+    for (int run = 0; run < 15; ++run) {
+        ref_us = std::min(ref_us, timeRounds(rounds, [&](uint8_t c) { test.ref(ref, c); }));
+        lcd.beginFrame();
+        span_us = std::min(span_us, timeRounds(rounds, [&](uint8_t c) { test.span(lcd, c); }));
+        lcd.endFrame();
+    }
+    volatile uint8_t sink = ref.lcd_buffer[4][64];  // 防止整段绘制被优化掉
+    (void)sink;
+}
+
+int main() {
+    int failed = 0;
+    for (const Case& test : CASES) {
+        bool same = sameOutput(test);
+        double ref, span;
+        measure(test, 2000, ref, span);
+        double speedup = ref / span;
+        bool slow = test.fill && speedup < FILL_MIN_SPEEDUP;
+        printf("%-18s baseline %7.2fus  span %6.2fus  %5.1fx  %s%s\n", test.name, ref, span, speedup,
+               same ? "identical" : "MISMATCH", slow ? "  BELOW LIMIT" : "");
+        if (!same || slow) failed++;
+    }
+    printf("fill speedup limit %.1fx\n", FILL_MIN_SPEEDUP);
+    return failed;
+}
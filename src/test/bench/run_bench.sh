@@ -0,0 +1,53 @@
+#!/bin/sh
+# 主机端基准：在项目根目录执行 sh src/test/bench/run_bench.sh（目标板大小对比见size_compare.sh）
+# 1) Dispatcher::trigger()在MAX_EVENT_TYPES=8~46下的耗时：各取REPEAT次运行的中位数，
+#    最大/最小比超过DISPATCH_LIMIT视为失败（单次调用只有几ns，单次运行的比值会随机波动）
+# 2) LCD按页span填充与逐点drawPoint的耗时对比，两者画面不一致视为失败
+# 各基准独立运行，任一失败时脚本最终返回非0
+CXX=${CXX:-g++}
+OUT=${TMPDIR:-/tmp}/stm32template_bench
+REPEAT=${REPEAT:-5}
+DISPATCH_LIMIT=${DISPATCH_LIMIT:-2.0}  # 线性查找时46/8应接近5.75倍
+BENCH=src/test/bench
+mkdir -p "$OUT"
+status=0
+
+dispatch_bench() {
+    sizes="8 16 24 32 40 46"
+    for n in $sizes; do
+        $CXX -std=c++17 -O2 -DMAX_EVENT_TYPES=$n -Iinclude $BENCH/dispatch_bench.cpp -o "$OUT/dispatch_$n" || return 1
+        : > "$OUT/dispatch_$n.txt"
+    done
+    # 各尺寸交替运行，抵消频率漂移
+    i=0
+    while [ $i -lt "$REPEAT" ]; do
+        for n in $sizes; do
+            "$OUT/dispatch_$n" | sed 's/.*last=\([0-9.]*\)ns/\1/' >> "$OUT/dispatch_$n.txt" || return 1
+        done
+        i=$((i + 1))
+    done
+    medians=""
+    for n in $sizes; do
+        median=$(sort -n "$OUT/dispatch_$n.txt" | awk '{ v[NR] = $1 } END { print v[int((NR + 1) / 2)] }')
+        echo "MAX_EVENT_TYPES=$n last(median of $REPEAT)=${median}ns"
+        medians="$medians $median"
+    done
+    echo "$medians" | awk -v limit="$DISPATCH_LIMIT" '{ min = $1; max = $1
+        for (i = 2; i <= NF; i++) { if ($i < min) min = $i; if ($i > max) max = $i }
+        printf "trigger max/min = %.2f (limit %.2f)\n", max / min, limit
+        if (max > min * limit) exit 1 }'
+}
+
+lcd_fill_bench() {
+    $CXX -std=c++17 -O2 -DUNIT_TEST -Isrc/test/native -Isrc $BENCH/lcd_fill_bench.cpp \
+        src/DigitalCircuit/HS12864TG10B.cpp -o "$OUT/lcd_fill" || return 1
+    "$OUT/lcd_fill"
+}
+
+for bench in dispatch_bench lcd_fill_bench; do
+    if ! $bench; then
+        echo "$bench FAILED"
+        status=1
+    fi
+done
+exit $status
@@ -0,0 +1,27 @@
+#!/bin/sh
+# 目标板固件大小对比：在项目根目录执行 sh src/test/bench/size_compare.sh <基准提交> [环境名]
+# 分别在基准提交与当前工作区构建固件，输出arm-none-eabi-size的text/data/bss及差值。
+# 需要PlatformIO（pio）；周期数请在板上开启_EventProfile，用dumpStats()读取DWT计数
+set -e
+BASE=${1:?usage: size_compare.sh <base-rev> [env]}
+ENV=${2:-genericSTM32F103C6}
+OUT=${TMPDIR:-/tmp}/stm32template_size
+WT="$OUT/base"
+
+rm -rf "$OUT"
+mkdir -p "$OUT"
+git worktree prune
+git worktree add --detach "$WT" "$BASE" >/dev/null
+trap 'git worktree remove --force "$WT"' EXIT
+
+measure() {
+    (cd "$1" && pio run -e "$ENV" >/dev/null)
+    SIZE=$(ls ~/.platformio/packages/toolchain-gccarmnoneeabi/bin/arm-none-eabi-size 2>/dev/null || echo arm-none-eabi-size)
+    "$SIZE" "$1/.pio/build/$ENV/firmware.elf" | awk 'NR == 2 { print $1, $2, $3 }'
+}
+
+set -- $(measure "$WT") $(measure .)
+echo "          text   data    bss"
+printf "base  %8d %6d %6d\n" "$1" "$2" "$3"
+printf "head  %8d %6d %6d\n" "$4" "$5" "$6"
+printf "diff  %8d %6d %6d\n" $(($4 - $1)) $(($5 - $2)) $(($6 - $3))
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief 主机（env:native）单元测试用的最小HAL替身
+ * @details 只提供LCD驱动与事件定义用到的GPIO端口、写引脚与毫秒节拍；HAL_Delay()不等待，只推进节拍，
+ *          测试可直接修改hal_native_tick模拟时间流逝
+ */
+typedef struct {
+    volatile uint32_t CRL;
+    volatile uint32_t CRH;
+    volatile uint32_t IDR;
+    volatile uint32_t ODR;
+    volatile uint32_t BSRR;
+    volatile uint32_t BRR;
+    volatile uint32_t LCKR;
+} GPIO_TypeDef;
+
+typedef enum {
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+#define GPIO_PIN_0  ((uint16_t)0x0001)
+#define GPIO_PIN_1  ((uint16_t)0x0002)
+#define GPIO_PIN_2  ((uint16_t)0x0004)
+#define GPIO_PIN_3  ((uint16_t)0x0008)
+#define GPIO_PIN_4  ((uint16_t)0x0010)
+#define GPIO_PIN_5  ((uint16_t)0x0020)
+#define GPIO_PIN_6  ((uint16_t)0x0040)
+#define GPIO_PIN_7  ((uint16_t)0x0080)
+#define GPIO_PIN_8  ((uint16_t)0x0100)
+#define GPIO_PIN_9  ((uint16_t)0x0200)
+#define GPIO_PIN_10 ((uint16_t)0x0400)
+#define GPIO_PIN_11 ((uint16_t)0x0800)
+#define GPIO_PIN_12 ((uint16_t)0x1000)
+#define GPIO_PIN_13 ((uint16_t)0x2000)
+#define GPIO_PIN_14 ((uint16_t)0x4000)
+#define GPIO_PIN_15 ((uint16_t)0x8000)
+#define GPIO_PIN_All ((uint16_t)0xFFFF)
+
+// 端口只需地址互不相同（port_index()按地址比较）
+inline GPIO_TypeDef hal_native_ports[4];
+#define GPIOA (&hal_native_ports[0])
+#define GPIOB (&hal_native_ports[1])
+#define GPIOC (&hal_native_ports[2])
+#define GPIOD (&hal_native_ports[3])
+
+inline uint32_t hal_native_tick = 0;
+
+inline void HAL_GPIO_WritePin(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state) {
+    if (state == GPIO_PIN_SET) {
+        port->ODR |= pin;
+    } else {
+        port->ODR &= ~static_cast<uint32_t>(pin);
+    }
+}
+
+inline uint32_t HAL_GetTick() { return hal_native_tick; }
+
+inline void HAL_Delay(uint32_t ms) { hal_native_tick += ms; }
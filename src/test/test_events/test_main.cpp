@@ -0,0 +1,193 @@
+/**
+ * @brief 事件记录/回放的主机测试（pio test -e native）
+ * @details 按Manager的方式触发GPIO边沿事件并由EventRecorder记录，dump()成字节流后
+ *          用EventReplayer回放到新的监听器，核对事件顺序、边沿时间戳与记录tick；
+ *          另测中断投递的GpioEdgeEvent在队列中成对展开、满时整对丢弃
+ */
+#include <unity.h>
+#include <vector>
+#include "Events/Event.hpp"
+
+using namespace EmbeddedEvent;
+
+struct Seen {
+    uint8_t type;  // RECORD_ID
+    uint8_t port;
+    uint16_t pin;
+    GPIO_PinState state;
+    uint32_t timestamp;
+    bool hasData;
+};
+
+static uint32_t g_now = 0;  // 记录器的tick源
+static uint32_t nowTick() { return g_now; }
+
+static Dispatcher dispatcher;
+static std::vector<Seen> seen;
+static std::vector<uint32_t> ticks;
+
+template<typename T>
+static void onEdge(T& e) {
+    seen.push_back({T::RECORD_ID, port_index(e.Port), e.pin, e.state, e.timestamp, e.Data != nullptr});
+}
+
+void setUp() {
+    dispatcher.clearAllListeners();
+    dispatcher.attachRecorder(nullptr);
+    seen.clear();
+    ticks.clear();
+    g_now = 0;
+}
+
+void tearDown() {}
+
+// 与Manager轮询路径一致：GpioEdgeEvent展开为双边沿事件 + 对应的单边沿事件
+static void edge(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState state, uint32_t us) {
+    GpioEdgeEvent event(pin, port, state, nullptr);
+    event.timestamp = us;
+    event.dispatch(dispatcher);
+}
+
+static std::vector<uint8_t> dump(const EventRecorder& recorder) {
+    std::vector<uint8_t> out;
+    recorder.dump([&](const uint8_t* data, size_t len) { out.insert(out.end(), data, data + len); });
+    return out;
+}
+
+static size_t replay(const std::vector<uint8_t>& bytes) {
+    dispatcher.attachRecorder(nullptr);
+    dispatcher.clearAllListeners();
+    dispatcher.registerListener<GpioEvent>(&onEdge<GpioEvent>);
+    dispatcher.registerListener<GpioRisingEvent>(&onEdge<GpioRisingEvent>);
+    dispatcher.registerListener<GpioFallingEvent>(&onEdge<GpioFallingEvent>);
+    EventReplayer<> replayer;
+    replayer.registerType<GpioEvent>();
+    replayer.registerType<GpioRisingEvent>();
+    replayer.registerType<GpioFallingEvent>();
+    return replayer.replay(dispatcher, bytes.data(), bytes.size(), [](uint32_t tick) { ticks.push_back(tick); });
+}
+
+// 负载保留us时间戳，且不含未初始化的填充字节
+static void test_payload_layout() {
+    TEST_ASSERT_EQUAL_UINT32(8, sizeof(GpioEvent::Payload));
+    GpioEvent event(GPIO_PIN_3, GPIOB, GPIO_PIN_SET, nullptr);
+    event.timestamp = 0xA1B2C3D4u;
+    GpioEvent copy(event.payload());
+    TEST_ASSERT_EQUAL_UINT32(0xA1B2C3D4u, copy.timestamp);
+    TEST_ASSERT_EQUAL_PTR(GPIOB, copy.Port);
+    TEST_ASSERT_EQUAL_UINT16(GPIO_PIN_3, copy.pin);
+    TEST_ASSERT_EQUAL_INT(GPIO_PIN_SET, copy.state);
+    TEST_ASSERT_EQUAL_UINT8(0, event.payload().reserved);
+}
+
+// 记录→dump→回放：顺序、端口引脚、电平、边沿时间戳、记录tick全部复现
+static void test_record_dump_replay() {
+    EventRecorder recorder(nowTick);
+    dispatcher.attachRecorder(&recorder);
+    g_now = 10;
+    edge(GPIOA, GPIO_PIN_0, GPIO_PIN_SET, 10001u);
+    edge(GPIOA, GPIO_PIN_0, GPIO_PIN_RESET, 10251u);  // 250us的毛刺：现场时序问题靠时间戳复现
+    g_now = 4295;
+    edge(GPIOB, GPIO_PIN_15, GPIO_PIN_SET, 4294967290u);  // 接近us计数回绕
+    TEST_ASSERT_EQUAL_UINT32(6, recorder.size());
+
+    std::vector<uint8_t> bytes = dump(recorder);
+    TEST_ASSERT_EQUAL_UINT32(6 + 6 * (6 + sizeof(GpioEvent::Payload)), bytes.size());
+    TEST_ASSERT_EQUAL_UINT32(6, replay(bytes));
+
+    static const Seen expected[] = {
+        {GpioEvent::RECORD_ID,        0, GPIO_PIN_0,  GPIO_PIN_SET,   10001u,      false},
+        {GpioRisingEvent::RECORD_ID,  0, GPIO_PIN_0,  GPIO_PIN_SET,   10001u,      false},
+        {GpioEvent::RECORD_ID,        0, GPIO_PIN_0,  GPIO_PIN_RESET, 10251u,      false},
+        {GpioFallingEvent::RECORD_ID, 0, GPIO_PIN_0,  GPIO_PIN_RESET, 10251u,      false},
+        {GpioEvent::RECORD_ID,        1, GPIO_PIN_15, GPIO_PIN_SET,   4294967290u, false},
+        {GpioRisingEvent::RECORD_ID,  1, GPIO_PIN_15, GPIO_PIN_SET,   4294967290u, false},
+    };
+    static const uint32_t expectedTicks[] = {10, 10, 10, 10, 4295, 4295};
+    TEST_ASSERT_EQUAL_UINT32(6, seen.size());
+    for (size_t i = 0; i < 6; ++i) {
+        TEST_ASSERT_EQUAL_UINT8(expected[i].type, seen[i].type);
+        TEST_ASSERT_EQUAL_UINT8(expected[i].port, seen[i].port);
+        TEST_ASSERT_EQUAL_UINT16(expected[i].pin, seen[i].pin);
+        TEST_ASSERT_EQUAL_INT(expected[i].state, seen[i].state);
+        TEST_ASSERT_EQUAL_UINT32(expected[i].timestamp, seen[i].timestamp);
+        TEST_ASSERT_FALSE(seen[i].hasData);
+        TEST_ASSERT_EQUAL_UINT32(expectedTicks[i], ticks[i]);
+    }
+}
+
+// 环形缓冲区写满后只保留最新EVENT_RECORDER_SIZE条，回放从最旧的一条开始
+static void test_ring_keeps_newest() {
+    EventRecorder recorder(nowTick);
+    dispatcher.attachRecorder(&recorder);
+    const uint32_t total = EVENT_RECORDER_SIZE + 5;
+    for (uint32_t i = 0; i < total; ++i) {
+        g_now = i;
+        GpioEvent event(GPIO_PIN_1, GPIOC, (i & 1) ? GPIO_PIN_SET : GPIO_PIN_RESET, nullptr);
+        event.timestamp = i * 100u;
+        dispatcher.trigger(event);
+    }
+    TEST_ASSERT_EQUAL_UINT32(EVENT_RECORDER_SIZE, replay(dump(recorder)));
+    TEST_ASSERT_EQUAL_UINT32(EVENT_RECORDER_SIZE, seen.size());
+    for (size_t i = 0; i < seen.size(); ++i) {
+        uint32_t n = total - EVENT_RECORDER_SIZE + i;
+        TEST_ASSERT_EQUAL_UINT32(n * 100u, seen[i].timestamp);
+        TEST_ASSERT_EQUAL_UINT32(n, ticks[i]);
+    }
+}
+
+// 每个边沿占一个槽位，出队展开为一对事件；队列满时整个边沿丢弃，不会只剩半对
+static void test_queued_edges_stay_paired() {
+    dispatcher.registerListener<GpioEvent>(&onEdge<GpioEvent>);
+    dispatcher.registerListener<GpioRisingEvent>(&onEdge<GpioRisingEvent>);
+    dispatcher.registerListener<GpioFallingEvent>(&onEdge<GpioFallingEvent>);
+    const uint32_t edges = EVENT_QUEUE_SIZE + 3;
+    uint32_t posted = 0;
+    for (uint32_t i = 0; i < edges; ++i) {
+        GpioEdgeEvent edge(GPIO_PIN_5, GPIOA, (i & 1) ? GPIO_PIN_RESET : GPIO_PIN_SET, nullptr);
+        edge.timestamp = 1000u + i;
+        posted += dispatcher.post(edge) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL_UINT32(EVENT_QUEUE_SIZE, posted);
+    TEST_ASSERT_EQUAL_UINT32(3, dispatcher.queue().dropped());
+    while (dispatcher.dispatchQueued()) {}
+    TEST_ASSERT_EQUAL_UINT32(2 * EVENT_QUEUE_SIZE, seen.size());
+    for (size_t i = 0; i < seen.size(); i += 2) {
+        bool rising = ((i / 2) & 1) == 0;
+        TEST_ASSERT_EQUAL_UINT8(GpioEvent::RECORD_ID, seen[i].type);
+        TEST_ASSERT_EQUAL_UINT8(rising ? GpioRisingEvent::RECORD_ID : GpioFallingEvent::RECORD_ID, seen[i + 1].type);
+        TEST_ASSERT_EQUAL_UINT32(1000u + i / 2, seen[i].timestamp);
+        TEST_ASSERT_EQUAL_UINT32(seen[i].timestamp, seen[i + 1].timestamp);
+    }
+}
+
+// us时间戳按uint32_t回绕（约71.6分钟），跨回绕点的间隔用无符号减法仍然正确
+static void test_timestamp_wrap() {
+    const uint32_t wrap_ms = 4294967u;  // 2^32us ≈ 4294967.296ms
+    TEST_ASSERT_EQUAL_UINT32(4294967000u, tick_to_us(wrap_ms));
+    TEST_ASSERT_EQUAL_UINT32(704u, tick_to_us(wrap_ms + 1));
+    TEST_ASSERT_EQUAL_UINT32(2000u, tick_to_us(wrap_ms + 1) - tick_to_us(wrap_ms - 1));
+}
+
+// 截断的dump只回放完整的记录，错误的数据头不回放
+static void test_truncated_dump() {
+    EventRecorder recorder(nowTick);
+    dispatcher.attachRecorder(&recorder);
+    edge(GPIOA, GPIO_PIN_2, GPIO_PIN_SET, 7u);
+    std::vector<uint8_t> bytes = dump(recorder);
+    bytes.pop_back();
+    TEST_ASSERT_EQUAL_UINT32(1, replay(bytes));
+    bytes[0] = 'X';
+    TEST_ASSERT_EQUAL_UINT32(0, replay(bytes));
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_payload_layout);
+    RUN_TEST(test_record_dump_replay);
+    RUN_TEST(test_ring_keeps_newest);
+    RUN_TEST(test_queued_edges_stay_paired);
+    RUN_TEST(test_timestamp_wrap);
+    RUN_TEST(test_truncated_dump);
+    return UNITY_END();
+}
@@ -0,0 +1,175 @@
+/**
+ * @brief HS12864TG10B绘制结果与总线流量的主机测试（pio test -e native）
+ * @details 驱动接RecordingTransport，每个图元画完后把重建出的屏幕与golden/下的PBM逐字节比较，
+ *          并核对checksum()与该图元产生的数据/指令字节数。
+ *          改动绘制代码且确认新画面正确后，设置环境变量LCD_GOLDEN_UPDATE=1运行一次，
+ *          重新生成PBM并打印新的校验值与字节数，再更新下方期望值。
+ *          golden/baseline.pbm例外：它由仓库初始版本的驱动（lcd_buffer + 逐点drawPoint）渲染得到，
+ *          用来确认新实现与原实现画面一致，不随LCD_GOLDEN_UPDATE重新生成
+ */
+#include <unity.h>
+#include <cstdio>
+#include <cstdlib>
+#include "DigitalCircuit/HS12864TG10B.hpp"
+#include "DigitalCircuit/LcdRecorder.hpp"
+
+#ifndef LCD_GOLDEN_DIR
+#define LCD_GOLDEN_DIR "src/test/test_lcd/golden/"  // 相对项目根目录（pio test的工作目录）
+#endif
+
+struct Expect {
+    const char* name;   // golden/<name>.pbm
+    uint32_t checksum;  // RecordingTransport::checksum()
+    uint32_t data;      // 该图元发送的显示数据字节数
+    uint32_t commands;  // 该图元发送的指令字节数
+};
+
+static GPIO_TypeDef res_port;
+static RecordingTransport bus;
+static HS12864TG10B lcd(bus, &res_port, GPIO_PIN_4);
+
+void setUp() {
+    bus.reset();
+    lcd.setFont(HS12864TG10B::FONT_8X8);
+    lcd.init();  // 清屏并开显示
+    bus.resetStats();
+}
+
+void tearDown() {}
+
+static bool updating() {
+    const char* env = getenv("LCD_GOLDEN_UPDATE");
+    return env != nullptr && env[0] != '\0' && env[0] != '0';
+}
+
+// 读取golden/<name>.pbm并与当前屏幕逐字节比较
+static void compareGolden(const char* name, const uint8_t* pbm) {
+    static uint8_t golden[RecordingTransport::PBM_SIZE + 1];
+    char path[128];
+    snprintf(path, sizeof(path), "%s%s.pbm", LCD_GOLDEN_DIR, name);
+    FILE* f = fopen(path, "rb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+    size_t n = fread(golden, 1, sizeof(golden), f);
+    fclose(f);
+    TEST_ASSERT_EQUAL_size_t_MESSAGE(RecordingTransport::PBM_SIZE, n, path);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(golden, pbm, RecordingTransport::PBM_SIZE, path);
+}
+
+// 比较当前屏幕与golden图像、校验值和本次图元的总线流量
+static void check(const Expect& e) {
+    const RecordingTransport::Stats& s = bus.stats();
+    static uint8_t pbm[RecordingTransport::PBM_SIZE];
+    TEST_ASSERT_EQUAL_size_t(sizeof(pbm), bus.toPbm(pbm, sizeof(pbm)));
+
+    if (updating()) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s%s.pbm", LCD_GOLDEN_DIR, e.name);
+        FILE* f = fopen(path, "wb");
+        TEST_ASSERT_NOT_NULL_MESSAGE(f, path);
+        fwrite(pbm, 1, sizeof(pbm), f);
+        fclose(f);
+        printf("{\"%s\", 0x%08lXu, %lu, %lu},\n", e.name, static_cast<unsigned long>(bus.checksum()),
+               static_cast<unsigned long>(s.data), static_cast<unsigned long>(s.commands));
+        return;
+    }
+
+    compareGolden(e.name, pbm);
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(e.checksum, bus.checksum(), e.name);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(e.data, s.data, e.name);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(e.commands, s.commands, e.name);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, s.overflow, e.name);
+}
+
+static const Expect BLANK        = {"blank",        0xBCC31DC5u,   0,  0};
+static const Expect CHAR         = {"char",         0x808A3E75u,   5,  3};
+static const Expect CHAR_SPAN    = {"char_span",    0x0DCB5E75u,  10,  6};
+static const Expect STRING       = {"string",       0x5982F5E9u,  53, 12};
+static const Expect FILL         = {"fill",         0xBE5C4394u, 123,  9};
+static const Expect RECT         = {"rect",         0x29A8A745u, 174, 36};
+static const Expect SCROLL       = {"scroll",       0x02A21550u, 128,  4};
+static const Expect SCROLL_CLEAR = {"scroll_clear", 0xE46B4D54u,  59, 22};
+
+// 初始化后整屏为空，init()本身的流量在setUp()中清零
+static void test_blank() {
+    check(BLANK);
+}
+
+// 页对齐的单个8x8字符
+static void test_char() {
+    lcd.showAscii(8, 2, 'A', 1);
+    check(CHAR);
+}
+
+// 跨页的单个字符：上下两页各写一段
+static void test_char_span() {
+    lcd.drawChar(8, 13, 'A', 1);
+    check(CHAR_SPAN);
+}
+
+// 任意像素位置的字符串（跨两页，比例字体）
+static void test_string() {
+    lcd.setFont(HS12864TG10B::FONT_8X8_PROP);
+    lcd.drawString(3, 13, "Hi, LCD", 1);
+    check(STRING);
+}
+
+// 实心矩形（按页整字节填充）
+static void test_fill() {
+    lcd.drawRect(10, 10, 50, 30, 1, true);
+    check(FILL);
+}
+
+// 空心矩形
+static void test_rect() {
+    lcd.drawRect(20, 5, 100, 60, 1, false);
+    check(RECT);
+}
+
+// 硬件滚动8行、新行点亮：只统计scroll()本身的流量
+static void test_scroll() {
+    lcd.showAsciiStr(0, 0, "TOP", 1);
+    lcd.showAsciiStr(0, 7, "BOTTOM", 1);
+    lcd.drawRect(64, 20, 120, 40, 1, true);
+    bus.resetStats();
+    lcd.scroll(8, 1);
+    check(SCROLL);
+}
+
+// 硬件滚动8行、新行清空：只发送移入底部的旧内容所在的列
+static void test_scroll_clear() {
+    lcd.showAsciiStr(0, 0, "Hello, world!", 1);
+    lcd.showAsciiStr(16, 3, "row 3", 1);
+    bus.resetStats();
+    lcd.scroll(8, 0);
+    check(SCROLL_CLEAR);
+}
+
+// 与初始版本驱动的渲染结果比较：页对齐字符串（仅用'@'以下的字符，原实现的字库索引在'@'起溢出）、
+// 反色字符串、实心/嵌套擦除矩形、空心矩形与水平线
+static void test_matches_baseline() {
+    lcd.showAsciiStr(0, 0, "0123456789:;<=>?", 1);
+    lcd.showAsciiStr(8, 2, "#$%&*+-./", 1);
+    lcd.showAsciiStr(16, 3, "(42)", 0);
+    lcd.drawRect(4, 36, 60, 58, 1, true);
+    lcd.drawRect(20, 41, 44, 52, 0, true);
+    lcd.drawRect(70, 33, 123, 61, 1, false);
+    lcd.drawLine(72, 47, 121, 47, 1);
+    static uint8_t pbm[RecordingTransport::PBM_SIZE];
+    TEST_ASSERT_EQUAL_size_t(sizeof(pbm), bus.toPbm(pbm, sizeof(pbm)));
+    compareGolden("baseline", pbm);
+    TEST_ASSERT_EQUAL_UINT32(0, bus.stats().overflow);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_blank);
+    RUN_TEST(test_char);
+    RUN_TEST(test_char_span);
+    RUN_TEST(test_string);
+    RUN_TEST(test_fill);
+    RUN_TEST(test_rect);
+    RUN_TEST(test_scroll);
+    RUN_TEST(test_scroll_clear);
+    RUN_TEST(test_matches_baseline);
+    return UNITY_END();
+}